@@ -0,0 +1,119 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "DataReader.h"
+
+using namespace std;
+using namespace chrono;
+
+/**
+ * Data file reader benchmark
+ *
+ * Writes a synthetic two-column spectrum (if the file does not exist yet)
+ * and times three readers on it:
+ *   baseline - the original getline/istringstream loop
+ *   blocks   - DataReader with one thread (block reader with from_chars)
+ *   mapped   - DataReader with several threads (memory-mapped chunks)
+ * and checks that all three return the same points.
+ *
+ * Usage: reader_bench [file] [lines] [threads]
+ * (defaults: bench_data.dat, 10000000 lines, 4 threads)
+ */
+
+/**
+ * Write a synthetic spectrum: ascending ppm values, two Lorentzian peaks
+ * and a little deterministic noise, in the same format as testdata.dat
+ */
+static bool generate(const string& filename, size_t lines) {
+    FILE* out = fopen(filename.c_str(), "w");
+    if (out == nullptr) {
+        cerr << "Error: Cannot create " << filename << endl;
+        return false;
+    }
+
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < lines; i++) {
+        double x = -1.0 + 12.0 * static_cast<double>(i) / static_cast<double>(lines);
+        double y = 5000.0 / (1.0 + 400.0 * (x - 1.2) * (x - 1.2)) +
+                   3000.0 / (1.0 + 400.0 * (x - 3.6) * (x - 3.6));
+        seed = seed * 1103515245u + 12345u;
+        y += static_cast<double>((seed >> 16) % 1000) / 10.0 - 50.0;
+        fprintf(out, "%.6f %.2f\n", x, y);
+    }
+
+    fclose(out);
+    return true;
+}
+
+/**
+ * The reader as it was before block parsing (no sorting)
+ */
+static bool readBaseline(const string& filename, vector<double>& xData, vector<double>& yData) {
+    ifstream inFile(filename);
+    if (!inFile.is_open()) {
+        return false;
+    }
+
+    string line;
+    double x, y;
+    while (getline(inFile, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream iss(line);
+        if (iss >> x >> y) {
+            xData.push_back(x);
+            yData.push_back(y);
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    string filename = (argc > 1) ? argv[1] : "bench_data.dat";
+    size_t lines = (argc > 2) ? strtoull(argv[2], nullptr, 10) : 10000000;
+    int threads = (argc > 3) ? atoi(argv[3]) : 4;
+
+    if (!ifstream(filename).good()) {
+        cout << "Generating " << lines << " lines in " << filename << endl;
+        if (!generate(filename, lines)) {
+            return 1;
+        }
+    }
+
+    // Silence the reader's progress lines while timing
+    streambuf* saved = cout.rdbuf();
+    ostringstream sink;
+
+    vector<double> baseX, baseY;
+    auto t0 = steady_clock::now();
+    readBaseline(filename, baseX, baseY);
+    auto t1 = steady_clock::now();
+
+    cout.rdbuf(sink.rdbuf());
+    DataReader blocks;
+    bool blocksOk = blocks.readFromFile(filename, 1);
+    auto t2 = steady_clock::now();
+    DataReader mapped;
+    bool mappedOk = mapped.readFromFile(filename, threads);
+    auto t3 = steady_clock::now();
+    cout.rdbuf(saved);
+
+    bool same = blocksOk && mappedOk &&
+                blocks.xData == baseX && blocks.yData == baseY &&
+                mapped.xData == baseX && mapped.yData == baseY;
+
+    printf("points   : %zu\n", baseX.size());
+    printf("baseline : %.3f s\n", duration<double>(t1 - t0).count());
+    printf("blocks   : %.3f s\n", duration<double>(t2 - t1).count());
+    printf("mapped   : %.3f s (%d threads)\n", duration<double>(t3 - t2).count(), threads);
+    printf("results  : %s\n", same ? "identical" : "DIFFERENT");
+
+    return same ? 0 : 1;
+}
@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include <string>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -15,22 +16,54 @@ using namespace std;
  * Line 1: Input data filename
  * Line 2: Baseline adjustment
  * Line 3: Tolerance for numerical algorithms
- * Line 4: Filter type (0=none, 1=boxcar, 2=SG)
+ * Line 4: Filter type (0=none, 1=boxcar, 2=SG, 3=median, 4=Whittaker,
+ *         5=wavelet)
  * Line 5: Filter size (odd number)
  * Line 6: Number of filter passes
- * Line 7: Integration technique (0=Newton-Cotes, 1=Romberg, 2=Adaptive, 3=Quadrature)
+ * Line 7: Integration technique (0=Newton-Cotes, 1=Romberg, 2=Adaptive, 3=Quadrature,
+ *         4=Cumulative trapezoid on data, 5=Cumulative Simpson on data, 6=Automatic)
  * Line 8: Output filename
+ * 
+ * Optional lines after line 8 have the form "key value # comment":
+ * gaussOrder  - Gauss-Legendre points (8, 16, 32, 64 or 128; default 64)
+ * threads     - worker threads for parsing, integration and filtering (0 = all cores; default 1)
+ * integrationReport - print integration cost/error columns (0 or 1; default 0)
+ * fusedFilter - run all filter passes in one streaming sweep (0 or 1; default 0)
+ * sgOrder     - Savitzky-Golay polynomial order (0-6; default 2)
+ * filterBackend - 0 = choose by cost, 1 = direct passes, 2 = FFT (default 1)
+ * sgDerivatives - write SG first/second derivatives (0 or 1; default 0)
+ * medianPrepass - median window applied before the filter (odd; 0 = off, default 0)
+ * whittakerLambda - Whittaker smoothing parameter (>= 0; default 100)
+ * waveletType - wavelet family (0 = Haar, 1 = Daubechies-4; default 1)
+ * waveletLevels - wavelet decomposition levels (1-12; default 4)
+ * filterPrecision - 0 = double, 1 = float32 boxcar/SG filter path,
+ *                   2 = float32 checked against double (default 0)
+ * compareFilters - window sizes for the filter comparison file (e.g. "5 9 15"; default off)
  */
 class Config {
 public:
     string inputFilename;
     double baselineAdjustment;
     double tolerance;
-    int filterType;  // 0=none, 1=boxcar, 2=SG
+    int filterType;  // 0=none, 1=boxcar, 2=SG, 3=median, 4=Whittaker, 5=wavelet
     int filterSize;
     int filterPasses;
-    int integrationType;  // 0=Newton-Cotes, 1=Romberg, 2=Adaptive, 3=Quadrature
+    int integrationType;  // 0=Newton-Cotes, 1=Romberg, 2=Adaptive, 3=Quadrature, 4/5=data, 6=auto
     string outputFilename;
+    int gaussOrder;  // Gauss-Legendre points (8, 16, 32, 64, 128)
+    bool gaussOrderSet;  // gaussOrder given in the config file
+    int numThreads;  // worker threads (0 = all cores)
+    bool integrationReport;  // add integration cost/error columns
+    bool fusedFilter;  // run all filter passes in one memory sweep
+    int sgOrder;  // Savitzky-Golay polynomial order (0-6)
+    int filterBackend;  // 0=auto, 1=direct passes, 2=FFT
+    bool sgDerivatives;  // write SG first/second derivatives
+    int medianPrepass;  // median window before filtering (0 = off)
+    double whittakerLambda;  // Whittaker smoothing parameter
+    int waveletType;  // 0=Haar, 1=Daubechies-4
+    int waveletLevels;  // wavelet decomposition levels
+    int filterPrecision;  // 0=double, 1=float32 filter path, 2=float32 + double check
+    vector<int> compareSizes;  // window sizes for filter_comparison.txt (empty = off)
     
     Config();
     bool readFromFile(const string& configFile);
@@ -38,6 +71,10 @@ public:
     
     string getFilterTypeName() const;
     string getIntegrationTypeName() const;
+
+private:
+    // Parse one optional "key value" line (after line 8)
+    bool readOption(const string& line);
 };
 
 #endif // CONFIG_H
@@ -0,0 +1,107 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * Convolution class - Symmetric FIR convolution with reflection boundaries
+ *
+ * The first and last halfWidth outputs are computed with reflected indices;
+ * the interior runs branch-free, using AVX-512 or AVX2 when the CPU has it
+ * and a scalar loop otherwise. Common window sizes dispatch to unrolled
+ * FilterKernel<N> instantiations. Every path evaluates
+ *   out[i] = c[m] x[i] + sum_{j=1..m} c[m+j] (x[i-j] + x[i+j])
+ * in the same order, so results do not depend on which path ran.
+ */
+class Convolution {
+public:
+    /**
+     * Convolve with a symmetric kernel (coeffs[m-j] == coeffs[m+j])
+     * @param in - input samples (n values)
+     * @param out - output samples (n values, must not alias in)
+     * @param n - number of samples
+     * @param coeffs - kernel of 2*halfWidth+1 taps
+     * @param halfWidth - kernel half width m
+     */
+    static void symmetric(const double* in, double* out, size_t n,
+                          const double* coeffs, int halfWidth);
+
+    /**
+     * Compute outputs [begin, end) of an n-point symmetric convolution
+     * Used for tiles: in and out hold points [base, ...), and in must
+     * cover every (reflected) index the requested outputs read
+     * @param in - input samples starting at index base
+     * @param out - output samples starting at index base
+     * @param n - total number of samples (for the reflection boundaries)
+     * @param base - index of in[0] and out[0]
+     * @param begin - first output index
+     * @param end - one past the last output index
+     * @param coeffs - kernel of 2*halfWidth+1 taps
+     * @param halfWidth - kernel half width m
+     */
+    static void symmetric(const double* in, double* out, size_t n, size_t base,
+                          size_t begin, size_t end, const double* coeffs, int halfWidth);
+
+    /**
+     * Convolve float samples with double accumulators
+     * Follows the double path's operation order on the widened samples;
+     * only the stored outputs are rounded to float
+     * @param in - input samples (n values)
+     * @param out - output samples (n values, must not alias in)
+     * @param n - number of samples
+     * @param coeffs - kernel of 2*halfWidth+1 taps
+     * @param halfWidth - kernel half width m
+     */
+    static void symmetric(const float* in, float* out, size_t n,
+                          const double* coeffs, int halfWidth);
+
+    /**
+     * Smooth and differentiate in one sweep over the input
+     * Each window is read once and feeds three outputs; smooth is
+     * identical to symmetric(in, smooth, n, c0, halfWidth)
+     * @param in - input samples (n values)
+     * @param smooth - smoothed output (n values)
+     * @param first - first-derivative output (n values)
+     * @param second - second-derivative output (n values)
+     * @param n - number of samples
+     * @param c0 - symmetric smoothing kernel (2*halfWidth+1 taps)
+     * @param c1 - antisymmetric first-derivative kernel
+     * @param c2 - symmetric second-derivative kernel
+     * @param halfWidth - kernel half width m
+     */
+    static void smoothAndDerivatives(const double* in, double* smooth, double* first,
+                                     double* second, size_t n, const double* c0,
+                                     const double* c1, const double* c2, int halfWidth);
+
+    /**
+     * Reflect an index into [0, n) at both boundaries
+     * Mirrors once at each end, then clamps (for windows wider than the data)
+     * @param idx - index, possibly outside [0, n)
+     * @param n - number of samples
+     * @return index in [0, n)
+     */
+    static int reflectIndex(int idx, int n);
+
+    /**
+     * Name of the interior kernel selected for this CPU
+     * @return "AVX-512", "AVX2" or "scalar"
+     */
+    static const char* kernelName();
+
+    /**
+     * Check whether a window size has a compile-time unrolled kernel
+     * (5, 7, 9, 11, 17 and 25 points; other sizes use the generic kernel)
+     * @param windowSize - number of taps
+     * @return true if an unrolled kernel is used
+     */
+    static bool hasUnrolledKernel(int windowSize);
+
+private:
+    // Edge outputs [begin, end) with reflected indices
+    static void edge(const double* in, double* out, size_t n, size_t base,
+                     size_t begin, size_t end, const double* coeffs, int halfWidth);
+};
+
+#endif // CONVOLUTION_H
@@ -24,6 +24,12 @@ private:
     vector<double> d;  // cubic coefficients
     bool computed;
     
+    // Find interval i with x[i] <= xVal < x[i+1] (clamped for extrapolation)
+    size_t findInterval(double xVal) const;
+    
+    // Integral of piece i over [x[i], x[i] + u]
+    double pieceIntegral(size_t i, double u) const;
+    
 public:
     CubicSpline();
     
@@ -42,6 +48,14 @@ public:
      */
     double evaluate(double xVal) const;
     
+    /**
+     * Evaluate spline at many x values in one pass
+     * Ascending xVals are located by a forward scan instead of a binary search
+     * @param xVals - x values to evaluate at
+     * @param yVals - output, resized to xVals.size()
+     */
+    void evaluate(const vector<double>& xVals, vector<double>& yVals) const;
+    
     /**
      * Evaluate spline derivative at given x value
      * @param xVal - x value to evaluate at
@@ -49,6 +63,32 @@ public:
      */
     double evaluateDerivative(double xVal) const;
     
+    /**
+     * Integrate spline exactly from lower to upper
+     * Sums the closed-form integral of each cubic piece
+     * @param lower - lower bound
+     * @param upper - upper bound
+     * @return integral value
+     */
+    double integrate(double lower, double upper) const;
+    
+    /**
+     * Count spline pieces overlapping [lower, upper]
+     * @param lower - lower bound
+     * @param upper - upper bound
+     * @return number of pieces
+     */
+    size_t segmentCount(double lower, double upper) const;
+    
+    /**
+     * Sum of |jumps| in the third derivative at knots inside (lower, upper)
+     * These kinks limit the convergence of every quadrature rule
+     * @param lower - lower bound
+     * @param upper - upper bound
+     * @return total third-derivative jump
+     */
+    double thirdDerivativeJumps(double lower, double upper) const;
+    
     /**
      * Find x values where spline crosses a given y value
      * @param yVal - y value to find crossings for
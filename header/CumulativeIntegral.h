@@ -0,0 +1,58 @@
+#ifndef CUMULATIVEINTEGRAL_H
+#define CUMULATIVEINTEGRAL_H
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * CumulativeIntegral class - Prefix sums of partial integrals over raw samples
+ * 
+ * Integrates the (filtered) data points directly instead of the spline:
+ * - Trapezoid: piecewise linear between samples
+ * - Simpson: each interval uses the average of the quadratics through its
+ *   left and right neighbours (exact for cubics on a uniform grid)
+ * 
+ * After one O(n) build, any area including fractional end segments
+ * is a difference of two prefix values. On a (near-)uniform grid the
+ * interval lookup is a direct index calculation, so each query is O(1).
+ */
+class CumulativeIntegral {
+private:
+    vector<double> x;       // x data points
+    vector<double> y;       // y data points
+    vector<double> prefix;  // prefix[i] = integral from x[0] to x[i]
+    double invStep;         // 1 / average spacing, for direct index lookup
+    bool simpson;
+    bool computed;
+    
+    // Find i with x[i] <= t < x[i+1] (clamped to the data range)
+    size_t findInterval(double t) const;
+    
+    // Integral over [x[i], t] inside interval i
+    double partial(size_t i, double t) const;
+    
+public:
+    CumulativeIntegral();
+    
+    /**
+     * Build prefix sums for given data
+     * @param xData - x values (must be strictly increasing)
+     * @param yData - y values
+     * @param useSimpson - true for Simpson, false for trapezoid
+     * @return true if successful
+     */
+    bool compute(const vector<double>& xData, const vector<double>& yData, bool useSimpson);
+    
+    /**
+     * Integrate data from a to b
+     * @param a - lower bound
+     * @param b - upper bound
+     * @return integral value
+     */
+    double integrate(double a, double b) const;
+    
+    bool isComputed() const { return computed; }
+};
+
+#endif // CUMULATIVEINTEGRAL_H
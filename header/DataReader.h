@@ -20,12 +20,23 @@ public:
     vector<double> yData;
     
     DataReader();
-    bool readFromFile(const string& filename);
+    
+    /**
+     * Read "x y" lines from a text file (or a binary SpectrumFile,
+     * recognised by its magic bytes) and sort them by x
+     * With more than one thread, large files are memory-mapped and
+     * parsed in newline-aligned chunks on worker threads
+     * @param filename - path to data file
+     * @param numThreads - parser threads (0 = all cores; default 1)
+     * @return true if successful
+     */
+    bool readFromFile(const string& filename, int numThreads = 1);
     size_t size() const { return xData.size(); }
     void print(size_t numPoints = 10) const;
     
-    // Sort data by x-values in ascending order (keeping x,y pairs together)
-    void sortData();
+    // Sort data by x-values in ascending order (keeping x,y pairs together);
+    // strictly descending data is reversed in O(n)
+    void sortData(int numThreads = 1);
     
     // Check if data is sorted in ascending order
     bool isSorted() const;
@@ -36,6 +47,35 @@ public:
     // Correct baseline by subtracting estimated baseline value
     // Returns the baseline value that was subtracted
     double correctBaseline();
+
+private:
+    // Bytes read from the file per block
+    static const size_t readBlockSize = 1 << 22;
+    
+    // Files smaller than this are parsed on one thread
+    static const size_t parallelParseMinBytes = 1 << 23;
+    
+    // Unsorted inputs with fewer points than this are sorted on one thread
+    static const size_t parallelSortMinPoints = 1 << 16;
+    
+    // Load a binary spectrum file written by SpectrumFile::write (one copy
+    // per column out of the mapping; use SpectrumFile for read-only views)
+    bool readSpectrum(const string& filename);
+    
+    // Read the file block by block on the calling thread
+    bool readBlocks(const string& filename);
+    
+    // Memory-map the file and parse chunks in parallel; false if the
+    // file cannot be mapped (or is too small), leaving the data untouched
+    bool readMapped(const string& filename, int numThreads);
+    
+    // Parse every newline-terminated line in [begin, end) (and the last line
+    // too if atEnd); returns the start of the unparsed remainder
+    static const char* parseLines(const char* begin, const char* end, bool atEnd,
+                                  vector<double>& x, vector<double>& y);
+    
+    // Parse one "x y" line; false for blank, comment and malformed lines
+    static bool parseLine(const char* begin, const char* end, double& x, double& y);
 };
 
 #endif // DATAREADER_H
@@ -33,6 +33,19 @@ public:
                          const vector<double>& yData,
                          const string& header = "");
     
+    /**
+     * Write x followed by several y columns to a file
+     * @param filename - output filename
+     * @param xData - x values
+     * @param columns - y columns (each the same length as xData)
+     * @param header - optional header comment (e.g. column names)
+     * @return true if successful
+     */
+    static bool writeColumns(const string& filename,
+                            const vector<double>& xData,
+                            const vector<vector<double>>& columns,
+                            const string& header = "");
+    
     /**
      * Write spline-evaluated data at many points for plotting
      * @param filename - output filename
@@ -52,11 +65,13 @@ public:
      * @param filename - output filename
      * @param peaks - vector of detected peaks
      * @param baseline - baseline level
+     * @param showStats - add integration cost and error columns
      * @return true if successful
      */
     static bool writePeakData(const string& filename,
                              const vector<struct Peak>& peaks,
-                             double baseline);
+                             double baseline,
+                             bool showStats = false);
 };
 
 #endif // DATAWRITER_H
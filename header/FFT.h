@@ -0,0 +1,55 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * FFT class - In-place radix-2 complex fast Fourier transform
+ *
+ * The twiddle factors and bit-reversal permutation for one power-of-two
+ * size are built once in the constructor, so a plan can transform many
+ * blocks (from several threads; transforms do not modify the plan).
+ */
+class FFT {
+private:
+    size_t n;
+    vector<complex<double>> twiddles;  // exp(-2 pi i k / n), k < n/2
+    vector<size_t> bitReverse;         // bit-reversed index of each position
+
+    // Shared forward/inverse butterfly passes
+    void transform(complex<double>* data, bool inverse) const;
+
+public:
+    /**
+     * Build a plan for transforms of a given size
+     * @param size - transform length (must be a power of two)
+     */
+    explicit FFT(size_t size);
+
+    size_t size() const { return n; }
+
+    /**
+     * Forward transform: X[k] = sum_j x[j] exp(-2 pi i jk / n)
+     * @param data - n values, replaced by their transform
+     */
+    void forward(complex<double>* data) const;
+
+    /**
+     * Inverse transform, scaled by 1/n so inverse(forward(x)) = x
+     * @param data - n values, replaced by their inverse transform
+     */
+    void inverse(complex<double>* data) const;
+
+    /**
+     * Smallest power of two that is at least value
+     * @param value - requested size
+     * @return power of two >= value
+     */
+    static size_t nextPowerOfTwo(size_t value);
+};
+
+#endif // FFT_H
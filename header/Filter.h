@@ -2,6 +2,10 @@
 #define FILTER_H
 
 #include <vector>
+#include <string>
+#include <cstddef>
+#include <functional>
+#include <cmath>
 
 using namespace std;
 
@@ -10,7 +14,10 @@ using namespace std;
  * 
  * Supports:
  * - Boxcar (moving average) filter with cyclic boundary conditions
- * - Savitzky-Golay filter (5, 11, or 17 point)
+ * - Savitzky-Golay filter (any odd window, polynomial order 0-6)
+ * - Sliding-window median filter (spike removal)
+ * - Whittaker penalized least-squares smoother
+ * - Stationary wavelet denoising (Haar or Daubechies-4 lifting)
  */
 class Filter {
 public:
@@ -19,27 +26,286 @@ public:
      * @param data - input data to filter
      * @param filterSize - size of filter window (must be odd)
      * @param numPasses - number of times to apply the filter
+     * @param numThreads - threads for tiled filtering (0 = all cores; default 1)
+     * @param backend - 0 = choose by cost, 1 = direct passes, 2 = FFT (default 1)
      * @return filtered data
      */
     static vector<double> applyBoxcar(const vector<double>& data, 
-                                          int filterSize, int numPasses);
+                                          int filterSize, int numPasses, int numThreads = 1,
+                                          int backend = 1);
+    
+    /**
+     * Apply boxcar filter straight into a destination buffer
+     * Passes alternate between dest and scratch; no heap allocation
+     * @param data - input data (n values; may equal dest)
+     * @param dest - output buffer (n values)
+     * @param n - number of points
+     * @param filterSize - size of filter window (must be odd)
+     * @param numPasses - number of times to apply the filter
+     * @param scratch - work buffer (n values, distinct from data and dest)
+     */
+    static void applyBoxcar(const double* data, double* dest, size_t n,
+                            int filterSize, int numPasses, double* scratch);
+    
+    /**
+     * Apply boxcar filter in place
+     * Passes alternate between data and scratch; scratch is resized only
+     * if it is smaller than data, so repeated calls do not allocate
+     * @param data - data to filter (replaced by the result)
+     * @param filterSize - size of filter window (must be odd)
+     * @param numPasses - number of times to apply the filter
+     * @param scratch - caller-owned work buffer
+     */
+    static void applyBoxcarInPlace(vector<double>& data, int filterSize, int numPasses,
+                                   vector<double>& scratch);
+    
+    /**
+     * Apply multi-pass boxcar filter in a single sweep over memory
+     * Passes run as a pipeline of running sums that each keep only a
+     * small ring buffer; the result is bit-identical to applyBoxcar
+     * @param data - input data to filter
+     * @param filterSize - size of filter window (must be odd)
+     * @param numPasses - number of times to apply the filter
+     * @return filtered data
+     */
+    static vector<double> applyBoxcarFused(const vector<double>& data,
+                                           int filterSize, int numPasses);
+    
+    /**
+     * Apply any multi-pass filter in a single sweep over memory
+     * Runs the data through a StreamingFilter, so intermediate passes only
+     * ever hold a ring buffer; the result is bit-identical to the
+     * direct-pass batch filter
+     * @param data - input data to filter
+     * @param filterType - 1 = boxcar, 2 = Savitzky-Golay, 3 = median
+     * @param filterSize - size of filter window (odd)
+     * @param numPasses - number of times to apply the filter
+     * @param polyOrder - SG polynomial order (0-6, default 2)
+     * @return filtered data
+     */
+    static vector<double> applyFused(const vector<double>& data, int filterType,
+                                     int filterSize, int numPasses, int polyOrder = 2);
     
     /**
      * Apply Savitzky-Golay filter
      * @param data - input data to filter
-     * @param filterSize - size of filter window (5, 11, or 17)
+     * @param filterSize - size of filter window (odd, at least 3)
      * @param numPasses - number of times to apply the filter
+     * @param polyOrder - fitted polynomial order (0-6, default 2)
+     * @param numThreads - threads for tiled filtering (0 = all cores; default 1)
+     * @param backend - 0 = choose by cost, 1 = direct passes, 2 = FFT (default 1)
      * @return filtered data
      */
     static vector<double> applySavitzkyGolay(const vector<double>& data, 
-                                                  int filterSize, int numPasses);
+                                                  int filterSize, int numPasses,
+                                                  int polyOrder = 2, int numThreads = 1,
+                                                  int backend = 1);
+    
+    /**
+     * Apply Savitzky-Golay filter straight into a destination buffer
+     * Passes alternate between dest and scratch; no heap allocation
+     * @param data - input data (n values; may equal dest)
+     * @param dest - output buffer (n values)
+     * @param n - number of points
+     * @param filterSize - size of filter window (odd, at least 3)
+     * @param numPasses - number of times to apply the filter
+     * @param scratch - work buffer (n values, distinct from data and dest)
+     * @param polyOrder - fitted polynomial order (0-6, default 2)
+     */
+    static void applySavitzkyGolay(const double* data, double* dest, size_t n,
+                                   int filterSize, int numPasses, double* scratch,
+                                   int polyOrder = 2);
+    
+    /**
+     * Apply Savitzky-Golay filter in place
+     * @param data - data to filter (replaced by the result)
+     * @param filterSize - size of filter window (odd, at least 3)
+     * @param numPasses - number of times to apply the filter
+     * @param scratch - caller-owned work buffer
+     * @param polyOrder - fitted polynomial order (0-6, default 2)
+     */
+    static void applySavitzkyGolayInPlace(vector<double>& data, int filterSize, int numPasses,
+                                          vector<double>& scratch, int polyOrder = 2);
+    
+    /**
+     * Apply Savitzky-Golay filter and compute first and second derivatives
+     * of the smoothed signal in the same (final) convolution sweep
+     * Derivatives use reflection boundaries, so they tend to zero at the ends
+     * @param data - input data to filter
+     * @param filterSize - size of filter window (odd, at least 3)
+     * @param numPasses - number of smoothing passes (at least 1)
+     * @param polyOrder - fitted polynomial order (0-6)
+     * @param spacing - x distance between samples (derivatives are per x unit)
+     * @param smoothed - output: smoothed data
+     * @param firstDerivative - output: dy/dx of the smoothed data
+     * @param secondDerivative - output: d2y/dx2 of the smoothed data
+     * @return true if successful
+     */
+    static bool applySavitzkyGolayDerivatives(const vector<double>& data, int filterSize,
+                                              int numPasses, int polyOrder, double spacing,
+                                              vector<double>& smoothed,
+                                              vector<double>& firstDerivative,
+                                              vector<double>& secondDerivative);
+    
+    /**
+     * Apply sliding-window median filter
+     * Removes single-point spikes that boxcar smears and SG preserves;
+     * also used as a pre-pass before the smoothing filters
+     * @param data - input data to filter
+     * @param filterSize - size of filter window (odd)
+     * @param numPasses - number of times to apply the filter
+     * @return filtered data
+     */
+    static vector<double> applyMedian(const vector<double>& data, int filterSize, int numPasses);
+    
+    /**
+     * Apply Whittaker smoother
+     * Solves (I + lambda D'D) z = y with second differences D; one lambda
+     * replaces the window size and pass count of the window filters
+     * @param data - input data to filter
+     * @param lambda - smoothing parameter (>= 0; larger = smoother)
+     * @param numPasses - number of times to apply the smoother
+     * @return filtered data
+     */
+    static vector<double> applyWhittaker(const vector<double>& data, double lambda, int numPasses);
+    
+    /**
+     * Apply stationary wavelet denoising
+     * Soft-thresholds every detail band at its MAD noise estimate, which
+     * keeps narrow multiplets that window filters merge at low SNR
+     * @param data - input data to filter
+     * @param family - 0 = Haar, 1 = Daubechies-4
+     * @param levels - decomposition levels (1-12)
+     * @param numPasses - number of times to apply the filter
+     * @return filtered data
+     */
+    static vector<double> applyWavelet(const vector<double>& data, int family, int levels,
+                                       int numPasses);
+    
+    /**
+     * Run unfiltered, boxcar and SG variants for several window sizes
+     * The first pass of every variant comes from one sweep over the data:
+     * each window is loaded once (out to the widest size) and feeds all
+     * boxcar sums and SG accumulators. Further passes run per variant
+     * @param data - input data to filter
+     * @param sizes - window sizes (odd); each adds a boxcar column and,
+     *                for sizes of at least 3, an SG column
+     * @param numPasses - number of times to apply each filter
+     * @param polyOrder - SG polynomial order (0-6)
+     * @param numThreads - threads for the remaining passes (0 = all cores)
+     * @param names - output: one name per column ("none", "boxcar9", "sg11", ...)
+     * @return columns: data, boxcar per size, then SG per size (ascending sizes)
+     */
+    static vector<vector<double>> compareFilters(const vector<double>& data,
+                                                 const vector<int>& sizes, int numPasses,
+                                                 int polyOrder, int numThreads,
+                                                 vector<string>& names);
+    
+    /**
+     * Apply boxcar filter in single precision
+     * Samples are stored as float (half the memory traffic); window sums
+     * are accumulated in double, so only the stored values are rounded
+     * @param data - input data to filter
+     * @param filterSize - size of filter window (must be odd)
+     * @param numPasses - number of times to apply the filter
+     * @return filtered data
+     */
+    static vector<float> applyBoxcarFloat(const vector<float>& data, int filterSize, int numPasses);
+    
+    /**
+     * Apply Savitzky-Golay filter in single precision
+     * Float storage with double accumulators, in the same operation order
+     * as the double path
+     * @param data - input data to filter
+     * @param filterSize - size of filter window (odd, at least 3)
+     * @param numPasses - number of times to apply the filter
+     * @param polyOrder - fitted polynomial order (0-6, default 2)
+     * @return filtered data
+     */
+    static vector<float> applySavitzkyGolayFloat(const vector<float>& data, int filterSize,
+                                                 int numPasses, int polyOrder = 2);
 
 private:
-    // Helper function for single pass of boxcar filter
-    static vector<double> boxcarPass(const vector<double>& data, int filterSize);
+    // Streaming stages repeat the batch passes' arithmetic
+    friend class StreamingFilter;
+    
+    // Boxcar running sums are re-seeded at multiples of this index
+    static const size_t boxcarReseedInterval = 512;
+    
+    // Points per tile for threaded filtering (multiple of boxcarReseedInterval)
+    static const size_t filterTileSize = 16384;
+    
+    // Single filter pass from in to out (out must not alias in)
+    typedef function<void(const double* in, double* out, size_t n)> PassKernel;
+    
+    // Filter outputs [begin, end) of a pass; in and out hold points [base, ...)
+    typedef function<void(const double* in, double* out, size_t base,
+                          size_t begin, size_t end)> RangeKernel;
+    
+    // Helper function for single pass of boxcar filter (O(n) sliding window)
+    static void boxcarPassInto(const double* in, double* out, size_t n, int filterSize);
+    
+    // Boxcar outputs [begin, end) of an n-point pass (begin aligned to re-seeding)
+    static void boxcarPassRange(const double* in, double* out, size_t n, size_t base,
+                                size_t begin, size_t end, int filterSize);
+    
+    // Compensated (Neumaier) addition for running sums
+    static void neumaierAdd(double& sum, double& comp, double value) {
+        double t = sum + value;
+        if (fabs(sum) >= fabs(value)) {
+            comp += (sum - t) + value;
+        } else {
+            comp += (value - t) + sum;
+        }
+        sum = t;
+    }
+    
+    // Validate SG size/order (adjusting them if needed) and fetch coefficients
+    static const double* sgCoefficients(int& filterSize, int& polyOrder);
     
     // Helper function for single pass of SG filter
-    static vector<double> sgPass(const vector<double>& data, int filterSize);
+    static void sgPassInto(const double* in, double* out, size_t n,
+                           const double* coeffs, int halfWidth);
+    
+    // Single-precision pass from in to out (out must not alias in)
+    typedef function<void(const float* in, float* out, size_t n)> FloatPassKernel;
+    
+    // Boxcar pass over float samples with a double running sum
+    static void boxcarPassFloat(const float* in, float* out, size_t n, int filterSize);
+    
+    // SG pass over float samples with double accumulators
+    static void sgPassFloat(const float* in, float* out, size_t n,
+                            const double* coeffs, int halfWidth);
+    
+    // Run float passes alternating between two buffers
+    static vector<float> runPassesFloat(const vector<float>& data, int numPasses,
+                                        const FloatPassKernel& kernel);
+    
+    // Single median pass in O(n log k)
+    static void medianPassInto(const double* in, double* out, size_t n, int filterSize);
+    
+    // Run passes alternating between dest and scratch, ending in dest
+    static void runPasses(const double* data, double* dest, size_t n, int numPasses,
+                          double* scratch, const PassKernel& kernel);
+    
+    // Run all passes tile by tile on worker threads (same result as serial)
+    static void runPassesTiled(const double* data, double* dest, size_t n, int numPasses,
+                               int halfWidth, size_t alignment, int numThreads,
+                               const RangeKernel& kernel);
+    
+    // Choose the FFT path for this backend setting and problem size
+    static bool useFFT(int backend, size_t n, int halfWidth, int numPasses, bool boxcar);
+    
+    // Overlap-save block size for a composite kernel half width
+    static size_t fftBlockSize(size_t compositeHalfWidth);
+    
+    // All passes of a symmetric kernel as one FFT convolution
+    static void fftPasses(const double* data, double* dest, size_t n, const double* kernel,
+                          int halfWidth, int numPasses, int numThreads);
+    
+    // Run passes in place, swapping data with scratch if needed
+    static void runPassesInPlace(vector<double>& data, int numPasses,
+                                 vector<double>& scratch, const PassKernel& kernel);
 };
 
 #endif // FILTER_H
@@ -0,0 +1,89 @@
+#ifndef GAUSSLEGENDRE_H
+#define GAUSSLEGENDRE_H
+
+using namespace std;
+
+/**
+ * GaussLegendreRule structure - N-point Gauss-Legendre rule on [-1, 1],
+ * generated at compile time
+ * 
+ * Nodes are the roots of P_N, found by Newton iteration from the
+ * asymptotic guess cos(pi (k + 0.75) / (N + 0.5)).
+ * Weights: w = 2 / ((1 - x^2) P_N'(x)^2)
+ * Only the positive half is stored (ascending); use symmetry for negative
+ * 
+ * Usage:
+ *   static constexpr GaussLegendreRule<64> rule{};
+ *   sum over i of rule.weights[i] * (f(rule.nodes[i]) + f(-rule.nodes[i]))
+ */
+template <int N>
+struct GaussLegendreRule {
+    static_assert(N % 2 == 0, "Only even-order rules are tabulated");
+    
+    double nodes[N / 2];
+    double weights[N / 2];
+    
+    constexpr GaussLegendreRule() : nodes(), weights() {
+        const double pi = 3.14159265358979323846;
+        
+        for (int k = 0; k < N / 2; k++) {
+            double x = cosine(pi * (k + 0.75) / (N + 0.5));
+            double p = 0.0;
+            double dp = 1.0;
+            
+            for (int iter = 0; iter < 100; iter++) {
+                legendre(x, p, dp);
+                double dx = p / dp;
+                x -= dx;
+                if (dx < 1e-16 && dx > -1e-16) {
+                    break;
+                }
+            }
+            legendre(x, p, dp);
+            
+            // k = 0 is the largest root; store in ascending order
+            nodes[N / 2 - 1 - k] = x;
+            weights[N / 2 - 1 - k] = 2.0 / ((1.0 - x * x) * dp * dp);
+        }
+    }
+    
+private:
+    /**
+     * Compile-time cosine for the Newton starting guesses (x in [0, pi])
+     * Reflects into [0, pi/2] and sums the Taylor series
+     */
+    static constexpr double cosine(double x) {
+        const double pi = 3.14159265358979323846;
+        double sign = 1.0;
+        if (x > pi / 2.0) {
+            x = pi - x;
+            sign = -1.0;
+        }
+        
+        double term = 1.0;
+        double sum = 1.0;
+        for (int k = 1; k < 30; k++) {
+            term *= -x * x / ((2.0 * k - 1.0) * (2.0 * k));
+            sum += term;
+        }
+        return sign * sum;
+    }
+    
+    /**
+     * Evaluate P_N(x) and P_N'(x) with the three-term recurrence
+     * (j+1) P_{j+1} = (2j+1) x P_j - j P_{j-1}
+     */
+    static constexpr void legendre(double x, double& p, double& dp) {
+        double p0 = 1.0;
+        double p1 = x;
+        for (int j = 1; j < N; j++) {
+            double p2 = ((2.0 * j + 1.0) * x * p1 - j * p0) / (j + 1.0);
+            p0 = p1;
+            p1 = p2;
+        }
+        p = p1;
+        dp = N * (x * p1 - p0) / (x * x - 1.0);
+    }
+};
+
+#endif // GAUSSLEGENDRE_H
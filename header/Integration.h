@@ -2,9 +2,22 @@
 #define INTEGRATION_H
 
 #include "CubicSpline.h"
+#include <vector>
 
 using namespace std;
 
+/**
+ * IntegrationStats structure - cost and accuracy of one integration
+ */
+struct IntegrationStats {
+    int evaluations;       // number of spline evaluations
+    int levels;            // refinement levels (recursion depth for adaptive)
+    bool converged;        // tolerance met before the refinement limit
+    double errorEstimate;  // achieved error estimate
+    
+    IntegrationStats() : evaluations(0), levels(0), converged(false), errorEstimate(0.0) {}
+};
+
 /**
  * Integration class - Numerical integration methods
  * 
@@ -12,7 +25,7 @@ using namespace std;
  * - Newton-Cotes (composite trapezoidal/Simpson's)
  * - Romberg integration
  * - Adaptive quadrature
- * - Gauss-Legendre quadrature (64 points)
+ * - Gauss-Legendre quadrature (8, 16, 32, 64 or 128 points)
  */
 class Integration {
 public:
@@ -22,9 +35,11 @@ public:
      * @param a - lower bound
      * @param b - upper bound
      * @param tolerance - error tolerance
+     * @param stats - optional cost and error report
      * @return integral value
      */
-    static double newtonCotes(const CubicSpline& spline, double a, double b, double tolerance);
+    static double newtonCotes(const CubicSpline& spline, double a, double b, double tolerance,
+                              IntegrationStats* stats = nullptr);
     
     /**
      * Integrate using Romberg method
@@ -32,9 +47,11 @@ public:
      * @param a - lower bound
      * @param b - upper bound
      * @param tolerance - error tolerance
+     * @param stats - optional cost and error report
      * @return integral value
      */
-    static double romberg(const CubicSpline& spline, double a, double b, double tolerance);
+    static double romberg(const CubicSpline& spline, double a, double b, double tolerance,
+                          IntegrationStats* stats = nullptr);
     
     /**
      * Integrate using adaptive quadrature
@@ -42,18 +59,72 @@ public:
      * @param a - lower bound
      * @param b - upper bound
      * @param tolerance - error tolerance
+     * @param stats - optional cost and error report
      * @return integral value
      */
-    static double adaptive(const CubicSpline& spline, double a, double b, double tolerance);
+    static double adaptive(const CubicSpline& spline, double a, double b, double tolerance,
+                           IntegrationStats* stats = nullptr);
     
     /**
-     * Integrate using Gauss-Legendre quadrature (64 points)
+     * Integrate using Gauss-Legendre quadrature
+     * Nodes and weights are generated at compile time
      * @param spline - cubic spline to integrate
      * @param a - lower bound
      * @param b - upper bound
+     * @param order - number of points (8, 16, 32, 64 or 128)
+     * @param stats - optional cost and error report; the error estimate
+     *                compares against the rule with half as many points
+     *                (converged is left false: the rule has no tolerance)
      * @return integral value
      */
-    static double gaussLegendre(const CubicSpline& spline, double a, double b);
+    static double gaussLegendre(const CubicSpline& spline, double a, double b, int order = 64,
+                                IntegrationStats* stats = nullptr);
+    
+    /**
+     * Integrate many intervals at once using Gauss-Legendre quadrature
+     * Nodes of every interval are gathered into one array and evaluated
+     * with a single bulk spline pass, then reduced per interval
+     * @param spline - cubic spline to integrate
+     * @param a - lower bounds
+     * @param b - upper bounds (same length as a)
+     * @param order - number of points (8, 16, 32, 64 or 128)
+     * @param stats - optional cost and error report for each interval
+     * @return integral value for each interval
+     */
+    static vector<double> gaussLegendreBatch(const CubicSpline& spline,
+                                             const vector<double>& a,
+                                             const vector<double>& b,
+                                             int order = 64,
+                                             vector<IntegrationStats>* stats = nullptr);
+    
+    /**
+     * Choose the cheapest integrator expected to meet the tolerance
+     * 
+     * Cost model (calibrated on the bundled spectra) uses the peak width,
+     * the number of spline pieces it covers and the third-derivative
+     * jumps at the knots, which limit the convergence of every rule:
+     * - Gauss-Legendre N: error ~ J (w/N)^4, cost N
+     * - Newton-Cotes: doubles n until J (2w/n)^4 meets tol, cost ~ 2n
+     * - Adaptive: refines each piece to depth log2(w/h), cost ~ pieces * depth
+     * Romberg is not considered: across spline knots its extrapolation
+     * stalls at Simpson order, so it never beats Newton-Cotes
+     * @param spline - cubic spline to integrate
+     * @param a - lower bound
+     * @param b - upper bound
+     * @param tolerance - error tolerance
+     * @param gaussOrder - output, Gauss-Legendre points when 3 is chosen
+     * @param estimatedCost - output, predicted spline evaluations
+     * @return integration type (0=Newton-Cotes, 2=Adaptive, 3=Gauss-Legendre)
+     */
+    static int chooseMethod(const CubicSpline& spline, double a, double b, double tolerance,
+                            int& gaussOrder, double& estimatedCost);
+    
+    /**
+     * Check whether a Gauss-Legendre order is available
+     * @param order - number of points
+     * @return true if a table exists for this order
+     */
+    static bool isSupportedGaussOrder(int order);
 
 private:
     // Helper function for trapezoidal rule
@@ -61,7 +132,8 @@ private:
     
     // Helper for adaptive recursion
     static double adaptiveHelper(const CubicSpline& spline, double a, double b, 
-                                 double tolerance, double fa, double fb, double fmid);
+                                 double tolerance, double fa, double fb, double fmid,
+                                 int depth, IntegrationStats& stats);
 };
 
 #endif // INTEGRATION_H
@@ -0,0 +1,35 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+using namespace std;
+
+/**
+ * Parallel class - Runs independent loop iterations on worker threads
+ * 
+ * Each iteration must write only to its own output slot, so results do not
+ * depend on the number of threads or on scheduling order.
+ */
+class Parallel {
+public:
+    /**
+     * Resolve a requested thread count
+     * @param requested - number of threads (0 = all hardware threads)
+     * @return number of threads to use (at least 1)
+     */
+    static int resolveThreads(int requested);
+    
+    /**
+     * Run body(i) for every i in [0, count)
+     * Workers claim iterations one at a time from a shared counter
+     * @param count - number of iterations
+     * @param numThreads - number of threads (0 = all hardware threads)
+     * @param body - loop body
+     */
+    static void forEach(size_t count, int numThreads,
+                        const function<void(size_t)>& body);
+};
+
+#endif // PARALLEL_H
@@ -2,8 +2,10 @@
 #define PEAKDETECTOR_H
 
 #include <ostream>
+#include <string>
 #include <vector>
 #include "CubicSpline.h"
+#include "Integration.h"
 
 
 using namespace std;
@@ -18,6 +20,8 @@ struct Peak {
     double maximum;    // y-value at peak maximum
     double area;       // integrated area of peak
     int hydrogens;     // relative number of hydrogens
+    IntegrationStats stats;  // cost and error of the area integration
+    string method;     // integration method actually used
 };
 
 /**
@@ -42,13 +46,40 @@ public:
      * Integrate peak areas using specified method
      * @param peaks - peaks to integrate
      * @param spline - cubic spline to integrate
-     * @param integrationType - integration method (0-3)
+     * @param integrationType - integration method (0-3, 6=auto; 4-5 use integratePeaksRaw)
      * @param tolerance - integration tolerance
+     * @param gaussOrder - Gauss-Legendre points (integration type 3)
+     * @param numThreads - worker threads (0 = all cores); areas do not
+     *                     depend on this value
+     * @param collectStats - fill Peak::stats (Gauss-Legendre then also
+     *                       evaluates the half-order rule for its error)
      */
     static void integratePeaks(vector<Peak>& peaks,
                               const CubicSpline& spline,
                               int integrationType,
-                              double tolerance);
+                              double tolerance,
+                              int gaussOrder = 64,
+                              int numThreads = 1,
+                              bool collectStats = false);
+    
+    /**
+     * Integrate peak areas directly from the data samples
+     * Builds one prefix-sum table, then each area is O(1). The exact
+     * spline area is computed alongside and the difference is reported
+     * @param peaks - peaks to integrate
+     * @param spline - cubic spline fitted to the same data
+     * @param xData - x data points (ascending)
+     * @param yData - filtered y data points
+     * @param useSimpson - true for Simpson, false for trapezoid
+     * @param tolerance - a peak counts as converged when its data area is
+     *                    within this of the spline area
+     */
+    static void integratePeaksRaw(vector<Peak>& peaks,
+                                  const CubicSpline& spline,
+                                  const vector<double>& xData,
+                                  const vector<double>& yData,
+                                  bool useSimpson,
+                                  double tolerance);
     
     /**
      * Calculate relative hydrogen counts for peaks
@@ -59,15 +90,17 @@ public:
     /**
      * Print peak analysis results (to cout)
      * @param peaks - peaks to print
+     * @param showStats - add integration cost and error columns
      */
-    static void printPeaks(const vector<Peak>& peaks);
+    static void printPeaks(const vector<Peak>& peaks, bool showStats = false);
 
     /**
      * Print peak analysis results to output stream
      * @param os - output stream
      * @param peaks - peaks to print
+     * @param showStats - add integration cost and error columns
      */
-    static void printPeaks(ostream& os, const vector<Peak>& peaks);
+    static void printPeaks(ostream& os, const vector<Peak>& peaks, bool showStats = false);
 };
 
 #endif // PEAKDETECTOR_H
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef SAVITZKYGOLAY_H
+#define SAVITZKYGOLAY_H
+
+using namespace std;
+
+/**
+ * SavitzkyGolay class - Convolution coefficients for Savitzky-Golay smoothing
+ *
+ * Coefficients are built from Gram polynomials (Gorry, Analytical
+ * Chemistry, 62, 570 (1990)) for any odd window, polynomial order 0-6 and
+ * derivative 0-2. Common smoothing windows (5, 7, 9, 11, 17, 25 with
+ * orders 2 and 4) are compile-time tables; other combinations are
+ * generated once and cached.
+ */
+class SavitzkyGolay {
+public:
+    static const int maxPolyOrder = 6;
+    static const int maxDerivative = 2;
+
+    /**
+     * Check whether a window size and polynomial order can be used
+     * @param windowSize - number of points in the window (odd, at least 3)
+     * @param polyOrder - polynomial order (0-6, less than windowSize)
+     * @return true if coefficients can be generated
+     */
+    static bool isValid(int windowSize, int polyOrder);
+
+    /**
+     * Get convolution coefficients
+     * The returned table has windowSize entries (applied as
+     * sum_j c[m+j] y[i+j]) and stays valid for the life of the program
+     * (safe to call from any thread). Smoothing weights sum to 1 and are
+     * symmetric; first-derivative weights are antisymmetric. Derivatives
+     * are per unit sample spacing and are zero when derivative > polyOrder.
+     * @param windowSize - number of points in the window (odd, at least 3)
+     * @param polyOrder - polynomial order (0-6, less than windowSize)
+     * @param derivative - 0 = smoothing, 1 = first, 2 = second derivative
+     * @return pointer to coefficients, or nullptr if the request is invalid
+     */
+    static const double* coefficients(int windowSize, int polyOrder, int derivative = 0);
+};
+
+#endif // SAVITZKYGOLAY_H
@@ -0,0 +1,112 @@
+#ifndef SPECTRUMFILE_H
+#define SPECTRUMFILE_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * SpectrumFile class - Versioned binary columnar spectrum container
+ *
+ * Layout (native little-endian, all offsets in bytes):
+ *   0  magic "NMRSPEC" + NUL      8  format version (uint32)
+ *   12 flags (bit 0 = uniform grid)  16 point count (uint64)
+ *   24 grid start x0 (double)     32 grid step dx (double)
+ *   40 metadata size (uint64)     48 data offset (uint64, multiple of 64)
+ *   56 byte-order tag (uint32)    60 reserved
+ *   64 metadata: provenance as "key=value" lines
+ *   data offset: x column (absent for a uniform grid), then y column
+ *
+ * A uniform grid is stored as (x0, dx, n) instead of an x array. open()
+ * memory-maps the file, and xColumn()/yColumn() are read-only views that
+ * point straight into the mapping, with no parsing and no copy. Callers
+ * that modify the data (such as DataReader, whose x and y vectors are
+ * shifted and filtered in place) must copy the columns out once.
+ */
+class SpectrumFile {
+public:
+    static const uint32_t formatVersion = 1;
+
+    SpectrumFile();
+    ~SpectrumFile();
+
+    SpectrumFile(const SpectrumFile&) = delete;
+    SpectrumFile& operator=(const SpectrumFile&) = delete;
+
+    /**
+     * Map a spectrum file and validate its header
+     * @param filename - path to the binary file
+     * @return true if successful
+     */
+    bool open(const string& filename);
+
+    // Release the mapping (also done by the destructor)
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    size_t size() const { return count; }
+    bool hasUniformGrid() const { return uniform; }
+    double gridStart() const { return x0; }
+    double gridStep() const { return dx; }
+    const string& metadata() const { return meta; }
+
+    /**
+     * Explicit x column inside the mapping
+     * @return pointer to size() values, or nullptr for a uniform grid
+     */
+    const double* xColumn() const { return xValues; }
+
+    /**
+     * y column inside the mapping (valid until close())
+     * @return pointer to size() values
+     */
+    const double* yColumn() const { return yValues; }
+
+    /**
+     * x value of point i (from the grid or the x column)
+     * @param i - point index
+     * @return x value
+     */
+    double x(size_t i) const;
+
+    /**
+     * Check the magic bytes at the start of a file
+     * @param filename - path to any file
+     * @return true if it looks like a spectrum file
+     */
+    static bool isSpectrumFile(const string& filename);
+
+    /**
+     * Write a spectrum file
+     * x is stored as (x0, dx, n) if every point lies within gridTolerance
+     * of the uniform grid through the first and last points
+     * @param filename - output path
+     * @param xData - x values
+     * @param yData - y values
+     * @param metadata - provenance text ("key=value" lines)
+     * @param gridTolerance - largest x error accepted for a grid (default 0: exact
+     *                        up to rounding)
+     * @return true if successful
+     */
+    static bool write(const string& filename, const vector<double>& xData,
+                      const vector<double>& yData, const string& metadata,
+                      double gridTolerance = 0.0);
+
+private:
+    const char* base;         // start of the mapping (or owned buffer)
+    size_t mappedBytes;
+    bool mapped;              // base came from mmap (otherwise from buffer)
+    vector<char> buffer;      // whole-file copy where mmap is not available
+    size_t count;
+    bool uniform;
+    double x0;
+    double dx;
+    const double* xValues;
+    const double* yValues;
+    string meta;
+};
+
+#endif // SPECTRUMFILE_H
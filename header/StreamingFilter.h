@@ -0,0 +1,94 @@
+#ifndef STREAMINGFILTER_H
+#define STREAMINGFILTER_H
+
+#include <vector>
+#include <cstddef>
+#include <memory>
+
+using namespace std;
+
+/**
+ * StreamingFilter class - Multi-pass filtering of a stream of unknown length
+ *
+ * Samples are pushed in chunks and filtered samples come back as soon as
+ * their windows are complete. Each pass is a stage that keeps only a ring
+ * buffer of one chunk plus a few windows of samples, so memory is bounded
+ * by the number of passes and the window size, not the spectrum length.
+ * The left reflection boundary is applied as the stream starts; the right
+ * one is applied by finish(), once the length is known. Outputs are
+ * bit-identical to the batch Filter functions for the same settings.
+ *
+ * Usage:
+ *   StreamingFilter stream(1, 9, 3);
+ *   while (more data) stream.push(chunk, filtered);   // appends ready outputs
+ *   stream.finish(filtered);                          // appends the rest
+ */
+class StreamingFilter {
+public:
+    /**
+     * Set up the pass pipeline
+     * Invalid sizes are adjusted as in the batch filters (with a warning)
+     * @param filterType - 1 = boxcar, 2 = Savitzky-Golay, 3 = median
+     *                     (anything else passes samples through)
+     * @param filterSize - size of filter window (odd)
+     * @param numPasses - number of times to apply the filter
+     * @param polyOrder - SG polynomial order (0-6, default 2)
+     */
+    StreamingFilter(int filterType, int filterSize, int numPasses, int polyOrder = 2);
+    ~StreamingFilter();
+
+    /**
+     * Push input samples
+     * @param data - input samples
+     * @param count - number of samples
+     * @param filtered - outputs that became ready are appended here
+     */
+    void push(const double* data, size_t count, vector<double>& filtered);
+
+    /**
+     * Push a chunk of input samples
+     * @param chunk - input samples
+     * @param filtered - outputs that became ready are appended here
+     */
+    void push(const vector<double>& chunk, vector<double>& filtered);
+
+    /**
+     * End the stream: apply the right boundary and flush every stage
+     * No samples can be pushed afterwards
+     * @param filtered - remaining outputs are appended here
+     */
+    void finish(vector<double>& filtered);
+
+    /**
+     * Renumber the stream as if offset more samples had already passed
+     * For tests: reaches stream positions past 2^31 without pushing them.
+     * Every stage must be past the left boundary, and offset must be a
+     * multiple of each ring size and of the boxcar re-seed interval
+     * (a large power of two such as 2^31 works)
+     * @param offset - number of positions to skip
+     * @return false (stream unchanged) if the skip is not allowed
+     */
+    bool skipAhead(size_t offset);
+
+    size_t samplesIn() const { return received; }
+    size_t samplesOut() const { return emitted; }
+
+private:
+    // One pass of the pipeline (ring buffer plus running state)
+    class Stage;
+
+    // Samples fed through the pipeline at a time
+    static const size_t chunkSize = 1024;
+
+    vector<unique_ptr<Stage>> stages;
+    vector<double> pending;  // output of the previous stage
+    vector<double> next;     // output of the current stage
+    size_t received;
+    size_t emitted;
+    bool finished;
+
+    // Run one chunk (or the end-of-stream flush) through every stage
+    void runStages(const double* data, size_t count, bool last, vector<double>& filtered);
+};
+
+#endif // STREAMINGFILTER_H
@@ -0,0 +1,65 @@
+#ifndef WAVELET_H
+#define WAVELET_H
+
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * Wavelet class - Stationary (undecimated) wavelet denoising
+ *
+ * Each level splits the approximation into a new approximation and a
+ * detail band with lifting steps dilated by 2^level (the a trous form of
+ * the lifting scheme), so no level is decimated and the result does not
+ * depend on where the signal starts. Detail bands are soft-thresholded at
+ * sigma sqrt(2 ln n), with sigma estimated per band from the median
+ * absolute deviation, and the inverse lifting steps rebuild the signal.
+ * The samples are padded by point symmetry through each end sample, so
+ * constant and linear trends come back exactly, edges included.
+ * The transform works in place on one padded approximation array plus
+ * one detail array per level, all allocated once: O(n * levels) time
+ * (plus about 10 * 2^levels padding points per band).
+ */
+class Wavelet {
+public:
+    enum Family {
+        Haar = 0,         // two-tap average and difference
+        Daubechies4 = 1   // four-tap Daubechies (two vanishing moments)
+    };
+
+    static const int maxLevels = 12;
+
+    /**
+     * Denoise n samples
+     * @param in - input samples (n values)
+     * @param out - denoised output (n values; may equal in)
+     * @param n - number of samples
+     * @param family - Haar or Daubechies4
+     * @param levels - number of decomposition levels (1 to maxLevels)
+     * @param thresholdScale - multiplier on the universal threshold
+     *                         (1 = sigma sqrt(2 ln n), 0 = no denoising)
+     * @return true if successful
+     */
+    static bool denoise(const double* in, double* out, size_t n, int family, int levels,
+                        double thresholdScale = 1.0);
+
+    /**
+     * Name of a wavelet family
+     * @param family - Haar or Daubechies4
+     * @return "Haar", "Daubechies-4" or "Unknown"
+     */
+    static const char* familyName(int family);
+
+private:
+    // Split approx into approx and detail at dilation step (forward lifting)
+    static void forwardLevel(double* approx, double* detail, size_t n, size_t step, int family);
+
+    // Merge approx and detail back into approx (inverse lifting, averaging both shifts)
+    static void inverseLevel(double* approx, double* detail, size_t n, size_t step, int family);
+
+    // Soft-threshold one padded detail band (n samples plus pad at each end)
+    // at the MAD noise estimate of its n real samples
+    static void threshold(double* detail, size_t n, size_t pad, double scale, double* scratch);
+};
+
+#endif // WAVELET_H
@@ -0,0 +1,50 @@
+#ifndef WHITTAKER_H
+#define WHITTAKER_H
+
+#include <cstddef>
+#include <memory>
+
+using namespace std;
+
+/**
+ * Whittaker class - Penalized least-squares (Whittaker-Henderson) smoother
+ *
+ * The smoothed series z minimizes
+ *   sum_i (y_i - z_i)^2 + lambda sum_i (z_{i-1} - 2 z_i + z_{i+1})^2
+ * (Eilers, Analytical Chemistry, 75, 3631 (2003)), i.e. solves the
+ * pentadiagonal system (I + lambda D'D) z = y. The system is factored as
+ * L D L' with a banded Cholesky in O(n); factors are cached per
+ * (n, lambda), so smoothing further spectra of the same length costs
+ * only the two O(n) triangular solves.
+ */
+class Whittaker {
+public:
+    // Factorizations kept in the cache (least recently built is dropped)
+    static const size_t maxCachedFactors = 4;
+
+    /**
+     * Check whether a smoothing parameter can be used
+     * @param lambda - smoothing parameter (finite, >= 0)
+     * @return true if valid
+     */
+    static bool isValid(double lambda);
+
+    /**
+     * Smooth n samples (safe to call from any thread)
+     * @param y - input samples (n values)
+     * @param z - smoothed output (n values; may equal y)
+     * @param n - number of samples
+     * @param lambda - smoothing parameter (larger = smoother)
+     * @return true if successful
+     */
+    static bool smooth(const double* y, double* z, size_t n, double lambda);
+
+private:
+    // Banded L D L' factor of I + lambda D'D
+    struct Factor;
+
+    // Cached factor for (n, lambda), building it if needed
+    static shared_ptr<const Factor> factor(size_t n, double lambda);
+};
+
+#endif // WHITTAKER_H
@@ -1,4 +1,5 @@
 #include "Config.h"
+#include "Integration.h"
 
 using namespace std;
 
@@ -8,7 +9,11 @@ using namespace std;
 Config::Config() 
     : inputFilename(""), baselineAdjustment(0.0), tolerance(1e-8),
       filterType(0), filterSize(0), filterPasses(0), integrationType(0),
-      outputFilename("analysis.txt") {
+      outputFilename("analysis.txt"), gaussOrder(64), gaussOrderSet(false),
+      numThreads(1), integrationReport(false), fusedFilter(false), sgOrder(2),
+      filterBackend(1), sgDerivatives(false), medianPrepass(0),
+      whittakerLambda(100.0), waveletType(1), waveletLevels(4),
+      filterPrecision(0) {
 }
 
 /**
@@ -83,6 +88,14 @@ bool Config::readFromFile(const string& configFile) {
         lineNum++;
     }
     
+    // Read optional "key value" lines
+    while (getline(inFile, line)) {
+        if (!readOption(line)) {
+            inFile.close();
+            return false;
+        }
+    }
+    
     inFile.close();
     
     if (lineNum < 8) {
@@ -98,9 +111,74 @@ bool Config::readFromFile(const string& configFile) {
         filterSize++;
     }
     
+    // Validate Gauss-Legendre order
+    if (!Integration::isSupportedGaussOrder(gaussOrder)) {
+        cerr << "Warning: Gauss-Legendre order should be 8, 16, 32, 64, or 128. "
+                  << "Adjusting from " << gaussOrder << " to 64" << endl;
+        gaussOrder = 64;
+    }
+    
     return true;
 }
 
+/**
+ * Parse one optional configuration line
+ * Blank lines and lines starting with '#' are ignored
+ * @param line - line of the form "key value # comment"
+ * @return false if the value could not be read
+ */
+bool Config::readOption(const string& line) {
+    istringstream iss(line);
+    string key;
+    if (!(iss >> key) || key[0] == '#') {
+        return true;
+    }
+    
+    bool ok = true;
+    if (key == "gaussOrder") {
+        ok = static_cast<bool>(iss >> gaussOrder);
+        gaussOrderSet = ok;
+    } else if (key == "threads") {
+        ok = static_cast<bool>(iss >> numThreads) && numThreads >= 0;
+    } else if (key == "integrationReport") {
+        ok = static_cast<bool>(iss >> integrationReport);
+    } else if (key == "fusedFilter") {
+        ok = static_cast<bool>(iss >> fusedFilter);
+    } else if (key == "sgOrder") {
+        ok = static_cast<bool>(iss >> sgOrder) && sgOrder >= 0 && sgOrder <= 6;
+    } else if (key == "sgDerivatives") {
+        ok = static_cast<bool>(iss >> sgDerivatives);
+    } else if (key == "medianPrepass") {
+        ok = static_cast<bool>(iss >> medianPrepass) && medianPrepass >= 0 &&
+             (medianPrepass == 0 || medianPrepass % 2 == 1);
+    } else if (key == "whittakerLambda") {
+        ok = static_cast<bool>(iss >> whittakerLambda) && whittakerLambda >= 0.0;
+    } else if (key == "waveletType") {
+        ok = static_cast<bool>(iss >> waveletType) && waveletType >= 0 && waveletType <= 1;
+    } else if (key == "waveletLevels") {
+        ok = static_cast<bool>(iss >> waveletLevels) && waveletLevels >= 1 && waveletLevels <= 12;
+    } else if (key == "filterPrecision") {
+        ok = static_cast<bool>(iss >> filterPrecision) && filterPrecision >= 0 && filterPrecision <= 2;
+    } else if (key == "compareFilters") {
+        compareSizes.clear();
+        int size;
+        while (iss >> size) {
+            compareSizes.push_back(size);
+        }
+        ok = !compareSizes.empty();
+    } else if (key == "filterBackend") {
+        ok = static_cast<bool>(iss >> filterBackend) && filterBackend >= 0 && filterBackend <= 2;
+    } else {
+        cerr << "Warning: Unknown configuration option: " << key << endl;
+        return true;
+    }
+    
+    if (!ok) {
+        cerr << "Error: Invalid value for configuration option: " << key << endl;
+    }
+    return ok;
+}
+
 /**
  * Print configuration to console
  */
@@ -116,7 +194,41 @@ void Config::print() const {
         cout << "Filter Size         : " << filterSize << endl;
         cout << "Filter Passes       : " << filterPasses << endl;
     }
+    if (filterType == 2) {
+        cout << "SG Poly Order       : " << sgOrder << endl;
+    }
+    if (filterType == 4) {
+        cout << "Whittaker Lambda    : " << whittakerLambda << endl;
+    }
+    if (filterType == 5) {
+        cout << "Wavelet             : " << (waveletType == 0 ? "Haar" : "Daubechies-4")
+                  << ", " << waveletLevels << " levels" << endl;
+    }
+    if (filterPrecision == 1) {
+        cout << "Filter Precision    : Float32" << endl;
+    } else if (filterPrecision == 2) {
+        cout << "Filter Precision    : Float32 (checked against double)" << endl;
+    }
+    if (!compareSizes.empty()) {
+        cout << "Compare Filter Sizes:";
+        for (int size : compareSizes) {
+            cout << " " << size;
+        }
+        cout << endl;
+    }
+    if (medianPrepass > 0) {
+        cout << "Median Pre-pass     : " << medianPrepass << endl;
+    }
+    if ((filterType == 1 || filterType == 2) && filterBackend != 1) {
+        cout << "Filter Backend      : " << (filterBackend == 0 ? "Auto (by cost)" : "FFT") << endl;
+    }
     cout << "Integration Method  : " << getIntegrationTypeName() << endl;
+    if (integrationType == 3) {
+        cout << "Gauss-Legendre Order: " << gaussOrder << endl;
+    }
+    if (numThreads != 1) {
+        cout << "Threads             : " << numThreads << endl;
+    }
     cout << "Output File         : " << outputFilename << endl;
     cout << endl;
 }
@@ -129,6 +241,9 @@ string Config::getFilterTypeName() const {
         case 0: return "None, Filtering is Off";
         case 1: return "Boxcar (Cyclic)";
         case 2: return "Savitzky-Golay";
+        case 3: return "Median (Spike Removal)";
+        case 4: return "Whittaker (Penalized Least Squares)";
+        case 5: return "Wavelet (Stationary, Soft Threshold)";
         default: return "Unknown";
     }
 }
@@ -142,6 +257,9 @@ string Config::getIntegrationTypeName() const {
         case 1: return "Romberg";
         case 2: return "Adaptive Quadrature";
         case 3: return "Gauss-Legendre Quadrature";
+        case 4: return "Cumulative Trapezoid (Data)";
+        case 5: return "Cumulative Simpson (Data)";
+        case 6: return "Automatic (Cost Model)";
         default: return "Unknown";
     }
 }
@@ -0,0 +1,543 @@
+#include "Convolution.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CONVOLUTION_X86 1
+#include <immintrin.h>
+
+// GCC would otherwise fuse the separate multiply/add intrinsics into FMA
+// inside AVX-512 code, which rounds differently from the scalar path
+#if defined(__clang__)
+#define CONVOLUTION_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CONVOLUTION_TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#endif
+#endif
+
+using namespace std;
+
+namespace {
+
+// Instruction set used by the interior kernels
+enum SimdLevel { simdScalar, simdAVX2, simdAVX512 };
+
+SimdLevel detectSimdLevel() {
+#ifdef CONVOLUTION_X86
+    if (__builtin_cpu_supports("avx512f")) {
+        return simdAVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return simdAVX2;
+    }
+#endif
+    return simdScalar;
+}
+
+// Interior kernel: outputs [begin, end) where every tap is in range
+typedef void (*InteriorKernel)(const double* in, double* out, size_t begin, size_t end,
+                               const double* coeffs, int halfWidth);
+
+/**
+ * Interior kernels for an N-point window
+ * With N fixed the tap loop has a compile-time trip count and is fully
+ * unrolled; N = 0 is the generic kernel that reads halfWidth at runtime
+ */
+template<int N>
+struct FilterKernel {
+    static_assert(N == 0 || N % 2 == 1, "Window size must be odd");
+
+    static int width(int halfWidth) {
+        return N > 0 ? N / 2 : halfWidth;
+    }
+
+    // One output per iteration
+    static void scalar(const double* in, double* out, size_t begin, size_t end,
+                       const double* coeffs, int halfWidth) {
+        const int m = width(halfWidth);
+        for (size_t i = begin; i < end; i++) {
+            double sum = coeffs[m] * in[i];
+            for (int j = 1; j <= m; j++) {
+                sum += coeffs[m + j] * (in[i - j] + in[i + j]);
+            }
+            out[i] = sum;
+        }
+    }
+
+#ifdef CONVOLUTION_X86
+    // 8 outputs per iteration in two 4-lane accumulators
+    CONVOLUTION_TARGET("avx2")
+    static void avx2(const double* in, double* out, size_t begin, size_t end,
+                     const double* coeffs, int halfWidth) {
+        const int m = width(halfWidth);
+        size_t i = begin;
+        __m256d center = _mm256_set1_pd(coeffs[m]);
+        for (; i + 8 <= end; i += 8) {
+            __m256d acc0 = _mm256_mul_pd(center, _mm256_loadu_pd(in + i));
+            __m256d acc1 = _mm256_mul_pd(center, _mm256_loadu_pd(in + i + 4));
+            for (int j = 1; j <= m; j++) {
+                __m256d c = _mm256_set1_pd(coeffs[m + j]);
+                __m256d pair0 = _mm256_add_pd(_mm256_loadu_pd(in + i - j),
+                                              _mm256_loadu_pd(in + i + j));
+                __m256d pair1 = _mm256_add_pd(_mm256_loadu_pd(in + i + 4 - j),
+                                              _mm256_loadu_pd(in + i + 4 + j));
+                acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(c, pair0));
+                acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(c, pair1));
+            }
+            _mm256_storeu_pd(out + i, acc0);
+            _mm256_storeu_pd(out + i + 4, acc1);
+        }
+        scalar(in, out, i, end, coeffs, halfWidth);
+    }
+
+    // 16 outputs per iteration in two 8-lane accumulators
+    CONVOLUTION_TARGET("avx512f")
+    static void avx512(const double* in, double* out, size_t begin, size_t end,
+                       const double* coeffs, int halfWidth) {
+        const int m = width(halfWidth);
+        size_t i = begin;
+        __m512d center = _mm512_set1_pd(coeffs[m]);
+        for (; i + 16 <= end; i += 16) {
+            __m512d acc0 = _mm512_mul_pd(center, _mm512_loadu_pd(in + i));
+            __m512d acc1 = _mm512_mul_pd(center, _mm512_loadu_pd(in + i + 8));
+            for (int j = 1; j <= m; j++) {
+                __m512d c = _mm512_set1_pd(coeffs[m + j]);
+                __m512d pair0 = _mm512_add_pd(_mm512_loadu_pd(in + i - j),
+                                              _mm512_loadu_pd(in + i + j));
+                __m512d pair1 = _mm512_add_pd(_mm512_loadu_pd(in + i + 8 - j),
+                                              _mm512_loadu_pd(in + i + 8 + j));
+                acc0 = _mm512_add_pd(acc0, _mm512_mul_pd(c, pair0));
+                acc1 = _mm512_add_pd(acc1, _mm512_mul_pd(c, pair1));
+            }
+            _mm512_storeu_pd(out + i, acc0);
+            _mm512_storeu_pd(out + i + 8, acc1);
+        }
+        scalar(in, out, i, end, coeffs, halfWidth);
+    }
+#else
+    // Non-x86 builds use the scalar kernel everywhere
+    static void avx2(const double* in, double* out, size_t begin, size_t end,
+                     const double* coeffs, int halfWidth) {
+        scalar(in, out, begin, end, coeffs, halfWidth);
+    }
+
+    static void avx512(const double* in, double* out, size_t begin, size_t end,
+                       const double* coeffs, int halfWidth) {
+        scalar(in, out, begin, end, coeffs, halfWidth);
+    }
+#endif
+};
+
+// Dispatch table entry: kernels for one window size, indexed by SimdLevel
+struct KernelEntry {
+    int windowSize;
+    InteriorKernel kernels[3];
+};
+
+#define FILTER_KERNEL_ENTRY(N) \
+    { N, { FilterKernel<N>::scalar, FilterKernel<N>::avx2, FilterKernel<N>::avx512 } }
+
+const KernelEntry kernelTable[] = {
+    FILTER_KERNEL_ENTRY(5),
+    FILTER_KERNEL_ENTRY(7),
+    FILTER_KERNEL_ENTRY(9),
+    FILTER_KERNEL_ENTRY(11),
+    FILTER_KERNEL_ENTRY(17),
+    FILTER_KERNEL_ENTRY(25),
+};
+
+const KernelEntry genericKernel = FILTER_KERNEL_ENTRY(0);
+
+#undef FILTER_KERNEL_ENTRY
+
+/**
+ * Look up the interior kernel for a window size on this CPU
+ */
+InteriorKernel selectKernel(int windowSize) {
+    static const SimdLevel level = detectSimdLevel();
+    for (const KernelEntry& entry : kernelTable) {
+        if (entry.windowSize == windowSize) {
+            return entry.kernels[level];
+        }
+    }
+    return genericKernel.kernels[level];
+}
+
+// Fused kernel: outputs [begin, end) of smoothing plus first and second derivative
+typedef void (*DerivativeKernel)(const double* in, double* smooth, double* first,
+                                 double* second, size_t begin, size_t end,
+                                 const double* c0, const double* c1, const double* c2,
+                                 int halfWidth);
+
+/**
+ * Fused smoothing/derivative interior kernels
+ * Each input pair is loaded once and feeds three accumulators; the
+ * antisymmetric first-derivative kernel uses the pair difference.
+ * The smoothing output follows exactly the FilterKernel operation order.
+ */
+struct FusedDerivativeKernel {
+    static void scalar(const double* in, double* smooth, double* first, double* second,
+                       size_t begin, size_t end, const double* c0, const double* c1,
+                       const double* c2, int halfWidth) {
+        const int m = halfWidth;
+        for (size_t i = begin; i < end; i++) {
+            double s0 = c0[m] * in[i];
+            double s1 = 0.0;
+            double s2 = c2[m] * in[i];
+            for (int j = 1; j <= m; j++) {
+                double left = in[i - j];
+                double right = in[i + j];
+                s0 += c0[m + j] * (left + right);
+                s1 += c1[m + j] * (right - left);
+                s2 += c2[m + j] * (left + right);
+            }
+            smooth[i] = s0;
+            first[i] = s1;
+            second[i] = s2;
+        }
+    }
+
+#ifdef CONVOLUTION_X86
+    // 4 outputs of each kind per iteration
+    CONVOLUTION_TARGET("avx2")
+    static void avx2(const double* in, double* smooth, double* first, double* second,
+                     size_t begin, size_t end, const double* c0, const double* c1,
+                     const double* c2, int halfWidth) {
+        const int m = halfWidth;
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m256d center = _mm256_loadu_pd(in + i);
+            __m256d s0 = _mm256_mul_pd(_mm256_set1_pd(c0[m]), center);
+            __m256d s1 = _mm256_setzero_pd();
+            __m256d s2 = _mm256_mul_pd(_mm256_set1_pd(c2[m]), center);
+            for (int j = 1; j <= m; j++) {
+                __m256d left = _mm256_loadu_pd(in + i - j);
+                __m256d right = _mm256_loadu_pd(in + i + j);
+                __m256d sum = _mm256_add_pd(left, right);
+                s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_set1_pd(c0[m + j]), sum));
+                s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_set1_pd(c1[m + j]),
+                                                     _mm256_sub_pd(right, left)));
+                s2 = _mm256_add_pd(s2, _mm256_mul_pd(_mm256_set1_pd(c2[m + j]), sum));
+            }
+            _mm256_storeu_pd(smooth + i, s0);
+            _mm256_storeu_pd(first + i, s1);
+            _mm256_storeu_pd(second + i, s2);
+        }
+        scalar(in, smooth, first, second, i, end, c0, c1, c2, halfWidth);
+    }
+
+    // 8 outputs of each kind per iteration
+    CONVOLUTION_TARGET("avx512f")
+    static void avx512(const double* in, double* smooth, double* first, double* second,
+                       size_t begin, size_t end, const double* c0, const double* c1,
+                       const double* c2, int halfWidth) {
+        const int m = halfWidth;
+        size_t i = begin;
+        for (; i + 8 <= end; i += 8) {
+            __m512d center = _mm512_loadu_pd(in + i);
+            __m512d s0 = _mm512_mul_pd(_mm512_set1_pd(c0[m]), center);
+            __m512d s1 = _mm512_setzero_pd();
+            __m512d s2 = _mm512_mul_pd(_mm512_set1_pd(c2[m]), center);
+            for (int j = 1; j <= m; j++) {
+                __m512d left = _mm512_loadu_pd(in + i - j);
+                __m512d right = _mm512_loadu_pd(in + i + j);
+                __m512d sum = _mm512_add_pd(left, right);
+                s0 = _mm512_add_pd(s0, _mm512_mul_pd(_mm512_set1_pd(c0[m + j]), sum));
+                s1 = _mm512_add_pd(s1, _mm512_mul_pd(_mm512_set1_pd(c1[m + j]),
+                                                     _mm512_sub_pd(right, left)));
+                s2 = _mm512_add_pd(s2, _mm512_mul_pd(_mm512_set1_pd(c2[m + j]), sum));
+            }
+            _mm512_storeu_pd(smooth + i, s0);
+            _mm512_storeu_pd(first + i, s1);
+            _mm512_storeu_pd(second + i, s2);
+        }
+        scalar(in, smooth, first, second, i, end, c0, c1, c2, halfWidth);
+    }
+#else
+    static void avx2(const double* in, double* smooth, double* first, double* second,
+                     size_t begin, size_t end, const double* c0, const double* c1,
+                     const double* c2, int halfWidth) {
+        scalar(in, smooth, first, second, begin, end, c0, c1, c2, halfWidth);
+    }
+
+    static void avx512(const double* in, double* smooth, double* first, double* second,
+                       size_t begin, size_t end, const double* c0, const double* c1,
+                       const double* c2, int halfWidth) {
+        scalar(in, smooth, first, second, begin, end, c0, c1, c2, halfWidth);
+    }
+#endif
+};
+
+// Interior kernel over float samples with double accumulators
+typedef void (*FloatInteriorKernel)(const float* in, float* out, size_t begin, size_t end,
+                                    const double* coeffs, int halfWidth);
+
+/**
+ * Single-precision interior kernels
+ * Samples are widened to double as they are loaded and every sum runs in
+ * double, in the FilterKernel operation order; only the stored result is
+ * rounded to float. Each iteration reads half the bytes of the double kernel.
+ */
+struct FloatKernel {
+    static void scalar(const float* in, float* out, size_t begin, size_t end,
+                       const double* coeffs, int halfWidth) {
+        const int m = halfWidth;
+        for (size_t i = begin; i < end; i++) {
+            double sum = coeffs[m] * static_cast<double>(in[i]);
+            for (int j = 1; j <= m; j++) {
+                sum += coeffs[m + j] * (static_cast<double>(in[i - j]) + in[i + j]);
+            }
+            out[i] = static_cast<float>(sum);
+        }
+    }
+
+#ifdef CONVOLUTION_X86
+    // 8 outputs per iteration in two 4-lane accumulators
+    CONVOLUTION_TARGET("avx2")
+    static void avx2(const float* in, float* out, size_t begin, size_t end,
+                     const double* coeffs, int halfWidth) {
+        const int m = halfWidth;
+        size_t i = begin;
+        __m256d center = _mm256_set1_pd(coeffs[m]);
+        for (; i + 8 <= end; i += 8) {
+            __m256d acc0 = _mm256_mul_pd(center, _mm256_cvtps_pd(_mm_loadu_ps(in + i)));
+            __m256d acc1 = _mm256_mul_pd(center, _mm256_cvtps_pd(_mm_loadu_ps(in + i + 4)));
+            for (int j = 1; j <= m; j++) {
+                __m256d c = _mm256_set1_pd(coeffs[m + j]);
+                __m256d pair0 = _mm256_add_pd(_mm256_cvtps_pd(_mm_loadu_ps(in + i - j)),
+                                              _mm256_cvtps_pd(_mm_loadu_ps(in + i + j)));
+                __m256d pair1 = _mm256_add_pd(_mm256_cvtps_pd(_mm_loadu_ps(in + i + 4 - j)),
+                                              _mm256_cvtps_pd(_mm_loadu_ps(in + i + 4 + j)));
+                acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(c, pair0));
+                acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(c, pair1));
+            }
+            _mm_storeu_ps(out + i, _mm256_cvtpd_ps(acc0));
+            _mm_storeu_ps(out + i + 4, _mm256_cvtpd_ps(acc1));
+        }
+        scalar(in, out, i, end, coeffs, halfWidth);
+    }
+
+    // Float <-> double conversions; the all-lanes masked forms avoid GCC's
+    // false maybe-uninitialized warning on the unmasked intrinsics
+    CONVOLUTION_TARGET("avx512f")
+    static __m512d widen(__m256 x) {
+        return _mm512_maskz_cvtps_pd(0xFF, x);
+    }
+
+    CONVOLUTION_TARGET("avx512f")
+    static __m256 narrow(__m512d x) {
+        return _mm512_maskz_cvtpd_ps(0xFF, x);
+    }
+
+    // 16 outputs per iteration in two 8-lane accumulators
+    CONVOLUTION_TARGET("avx512f")
+    static void avx512(const float* in, float* out, size_t begin, size_t end,
+                       const double* coeffs, int halfWidth) {
+        const int m = halfWidth;
+        size_t i = begin;
+        __m512d center = _mm512_set1_pd(coeffs[m]);
+        for (; i + 16 <= end; i += 16) {
+            __m512d acc0 = _mm512_mul_pd(center, widen(_mm256_loadu_ps(in + i)));
+            __m512d acc1 = _mm512_mul_pd(center, widen(_mm256_loadu_ps(in + i + 8)));
+            for (int j = 1; j <= m; j++) {
+                __m512d c = _mm512_set1_pd(coeffs[m + j]);
+                __m512d pair0 = _mm512_add_pd(widen(_mm256_loadu_ps(in + i - j)),
+                                              widen(_mm256_loadu_ps(in + i + j)));
+                __m512d pair1 = _mm512_add_pd(widen(_mm256_loadu_ps(in + i + 8 - j)),
+                                              widen(_mm256_loadu_ps(in + i + 8 + j)));
+                acc0 = _mm512_add_pd(acc0, _mm512_mul_pd(c, pair0));
+                acc1 = _mm512_add_pd(acc1, _mm512_mul_pd(c, pair1));
+            }
+            _mm256_storeu_ps(out + i, narrow(acc0));
+            _mm256_storeu_ps(out + i + 8, narrow(acc1));
+        }
+        scalar(in, out, i, end, coeffs, halfWidth);
+    }
+#else
+    static void avx2(const float* in, float* out, size_t begin, size_t end,
+                     const double* coeffs, int halfWidth) {
+        scalar(in, out, begin, end, coeffs, halfWidth);
+    }
+
+    static void avx512(const float* in, float* out, size_t begin, size_t end,
+                       const double* coeffs, int halfWidth) {
+        scalar(in, out, begin, end, coeffs, halfWidth);
+    }
+#endif
+};
+
+} // namespace
+
+/**
+ * Convolve with a symmetric kernel over the whole signal
+ */
+void Convolution::symmetric(const double* in, double* out, size_t n,
+                            const double* coeffs, int halfWidth) {
+    symmetric(in, out, n, 0, 0, n, coeffs, halfWidth);
+}
+
+/**
+ * Convolve outputs [begin, end), splitting off the reflected edges
+ */
+void Convolution::symmetric(const double* in, double* out, size_t n, size_t base,
+                            size_t begin, size_t end, const double* coeffs, int halfWidth) {
+    size_t m = static_cast<size_t>(halfWidth);
+    if (n < 2 * m + 1) {
+        // No point has its whole window inside the data
+        edge(in, out, n, base, begin, end, coeffs, halfWidth);
+        return;
+    }
+
+    size_t interiorBegin = max(begin, m);
+    size_t interiorEnd = min(end, n - m);
+    if (interiorBegin >= interiorEnd) {
+        edge(in, out, n, base, begin, end, coeffs, halfWidth);
+        return;
+    }
+
+    // The interior kernel only uses relative offsets, so it works on local indices
+    InteriorKernel interior = selectKernel(2 * halfWidth + 1);
+    edge(in, out, n, base, begin, interiorBegin, coeffs, halfWidth);
+    interior(in, out, interiorBegin - base, interiorEnd - base, coeffs, halfWidth);
+    edge(in, out, n, base, interiorEnd, end, coeffs, halfWidth);
+}
+
+/**
+ * Single-precision convolution, splitting off the reflected edges
+ */
+void Convolution::symmetric(const float* in, float* out, size_t n,
+                            const double* coeffs, int halfWidth) {
+    static const FloatInteriorKernel kernels[3] = {
+        FloatKernel::scalar, FloatKernel::avx2, FloatKernel::avx512
+    };
+    static const SimdLevel level = detectSimdLevel();
+
+    size_t m = static_cast<size_t>(halfWidth);
+    int count = static_cast<int>(n);
+
+    auto edgeRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            int center = static_cast<int>(i);
+            double sum = coeffs[halfWidth] * static_cast<double>(in[i]);
+            for (int j = 1; j <= halfWidth; j++) {
+                double pair = static_cast<double>(in[reflectIndex(center - j, count)]) +
+                              in[reflectIndex(center + j, count)];
+                sum += coeffs[halfWidth + j] * pair;
+            }
+            out[i] = static_cast<float>(sum);
+        }
+    };
+
+    if (n < 2 * m + 1) {
+        edgeRange(0, n);
+        return;
+    }
+    edgeRange(0, m);
+    kernels[level](in, out, m, n - m, coeffs, halfWidth);
+    edgeRange(n - m, n);
+}
+
+/**
+ * Smoothing plus first and second derivative in one sweep
+ */
+void Convolution::smoothAndDerivatives(const double* in, double* smooth, double* first,
+                                       double* second, size_t n, const double* c0,
+                                       const double* c1, const double* c2, int halfWidth) {
+    static const DerivativeKernel kernels[3] = {
+        FusedDerivativeKernel::scalar, FusedDerivativeKernel::avx2, FusedDerivativeKernel::avx512
+    };
+    static const SimdLevel level = detectSimdLevel();
+
+    size_t m = static_cast<size_t>(halfWidth);
+    int count = static_cast<int>(n);
+
+    // Reflected edges (or everything, if no window fits inside the data)
+    auto edgeRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            int center = static_cast<int>(i);
+            double s0 = c0[halfWidth] * in[i];
+            double s1 = 0.0;
+            double s2 = c2[halfWidth] * in[i];
+            for (int j = 1; j <= halfWidth; j++) {
+                double left = in[reflectIndex(center - j, count)];
+                double right = in[reflectIndex(center + j, count)];
+                s0 += c0[halfWidth + j] * (left + right);
+                s1 += c1[halfWidth + j] * (right - left);
+                s2 += c2[halfWidth + j] * (left + right);
+            }
+            smooth[i] = s0;
+            first[i] = s1;
+            second[i] = s2;
+        }
+    };
+
+    if (n < 2 * m + 1) {
+        edgeRange(0, n);
+        return;
+    }
+    edgeRange(0, m);
+    kernels[level](in, smooth, first, second, m, n - m, c0, c1, c2, halfWidth);
+    edgeRange(n - m, n);
+}
+
+/**
+ * Reflect an index into [0, n) at both boundaries
+ */
+int Convolution::reflectIndex(int idx, int n) {
+    // Handle negative indices (mirror at start)
+    if (idx < 0) {
+        idx = -idx;
+    }
+    // Handle indices past end (mirror at end)
+    if (idx >= n) {
+        idx = 2 * n - idx - 2;
+    }
+    // Safety bounds (for double reflection)
+    if (idx < 0) {
+        idx = 0;
+    }
+    if (idx >= n) {
+        idx = n - 1;
+    }
+    return idx;
+}
+
+/**
+ * Name of the interior kernel selected for this CPU
+ */
+const char* Convolution::kernelName() {
+    switch (detectSimdLevel()) {
+        case simdAVX512: return "AVX-512";
+        case simdAVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+/**
+ * Check for a compile-time unrolled kernel
+ */
+bool Convolution::hasUnrolledKernel(int windowSize) {
+    for (const KernelEntry& entry : kernelTable) {
+        if (entry.windowSize == windowSize) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Edge outputs with reflected indices (same operation order as the interior)
+ */
+void Convolution::edge(const double* in, double* out, size_t n, size_t base,
+                       size_t begin, size_t end, const double* coeffs, int halfWidth) {
+    int count = static_cast<int>(n);
+    for (size_t i = begin; i < end; i++) {
+        int center = static_cast<int>(i);
+        double sum = coeffs[halfWidth] * in[i - base];
+        for (int j = 1; j <= halfWidth; j++) {
+            double pair = in[reflectIndex(center - j, count) - base] +
+                          in[reflectIndex(center + j, count) - base];
+            sum += coeffs[halfWidth + j] * pair;
+        }
+        out[i - base] = sum;
+    }
+}
@@ -1,6 +1,7 @@
 #include "CubicSpline.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include <armadillo>
 
 using namespace std;
@@ -165,6 +166,53 @@ double CubicSpline::evaluate(double xVal) const {
     return y[i] + b[i]*dx + c[i]*dx*dx + d[i]*dx*dx*dx;
 }
 
+/**
+ * Evaluate spline at many x values
+ * Keeps the interval index from the previous point and scans forward, so an
+ * ascending list costs O(n + m) instead of O(m log n). Falls back to binary
+ * search whenever xVals steps backwards. Results match evaluate(double).
+ */
+void CubicSpline::evaluate(const vector<double>& xVals, vector<double>& yVals) const {
+    yVals.assign(xVals.size(), 0.0);
+    
+    if (!computed || x.empty()) {
+        return;
+    }
+    
+    size_t n = x.size();
+    size_t i = 0;
+    
+    for (size_t k = 0; k < xVals.size(); k++) {
+        double xVal = xVals[k];
+        
+        // Find the interval [x_i, x_{i+1}] containing xVal
+        if (xVal <= x[0]) {
+            i = 0;
+        } else if (xVal >= x[n-1]) {
+            i = n - 2;
+        } else if (xVal < x[i]) {
+            // Stepped backwards - binary search
+            size_t left = 0, right = n - 1;
+            while (right - left > 1) {
+                size_t mid = (left + right) / 2;
+                if (xVal < x[mid]) {
+                    right = mid;
+                } else {
+                    left = mid;
+                }
+            }
+            i = left;
+        } else {
+            while (x[i+1] <= xVal) {
+                i++;
+            }
+        }
+        
+        double dx = xVal - x[i];
+        yVals[k] = y[i] + b[i]*dx + c[i]*dx*dx + d[i]*dx*dx*dx;
+    }
+}
+
 /**
  * Evaluate spline derivative at given x value
  * S'_i(x) = b_i + 2*c_i*(x-x_i) + 3*d_i*(x-x_i)^2
@@ -202,6 +250,107 @@ double CubicSpline::evaluateDerivative(double xVal) const {
     return b[i] + 2.0*c[i]*dx + 3.0*d[i]*dx*dx;
 }
 
+/**
+ * Exact spline integral from lower to upper
+ * Piece i integrates to y_i u + b_i u^2/2 + c_i u^3/3 + d_i u^4/4
+ */
+double CubicSpline::integrate(double lower, double upper) const {
+    if (!computed || x.empty()) {
+        return 0.0;
+    }
+    
+    if (upper < lower) {
+        return -integrate(upper, lower);
+    }
+    
+    size_t iLower = findInterval(lower);
+    size_t iUpper = findInterval(upper);
+    
+    if (iLower == iUpper) {
+        return pieceIntegral(iLower, upper - x[iLower]) -
+               pieceIntegral(iLower, lower - x[iLower]);
+    }
+    
+    // Partial first piece, whole middle pieces, partial last piece
+    double sum = pieceIntegral(iLower, x[iLower+1] - x[iLower]) -
+                 pieceIntegral(iLower, lower - x[iLower]);
+    for (size_t i = iLower + 1; i < iUpper; i++) {
+        sum += pieceIntegral(i, x[i+1] - x[i]);
+    }
+    sum += pieceIntegral(iUpper, upper - x[iUpper]);
+    
+    return sum;
+}
+
+/**
+ * Number of spline pieces overlapping [lower, upper]
+ */
+size_t CubicSpline::segmentCount(double lower, double upper) const {
+    if (!computed || x.empty()) {
+        return 0;
+    }
+    if (upper < lower) {
+        swap(lower, upper);
+    }
+    
+    return findInterval(upper) - findInterval(lower) + 1;
+}
+
+/**
+ * Sum of |S'''| jumps at interior knots; S'''_i = 6 d_i
+ */
+double CubicSpline::thirdDerivativeJumps(double lower, double upper) const {
+    if (!computed || x.empty()) {
+        return 0.0;
+    }
+    if (upper < lower) {
+        swap(lower, upper);
+    }
+    
+    size_t iLower = findInterval(lower);
+    size_t iUpper = findInterval(upper);
+    
+    double sum = 0.0;
+    for (size_t i = iLower + 1; i <= iUpper; i++) {
+        sum += 6.0 * fabs(d[i] - d[i-1]);
+    }
+    
+    return sum;
+}
+
+/**
+ * Find interval index, matching the search in evaluate()
+ */
+size_t CubicSpline::findInterval(double xVal) const {
+    size_t n = x.size();
+    
+    if (xVal <= x[0]) {
+        return 0;
+    }
+    if (xVal >= x[n-1]) {
+        return n - 2;
+    }
+    
+    size_t left = 0, right = n - 1;
+    while (right - left > 1) {
+        size_t mid = (left + right) / 2;
+        if (xVal < x[mid]) {
+            right = mid;
+        } else {
+            left = mid;
+        }
+    }
+    return left;
+}
+
+/**
+ * Integral of piece i from x[i] to x[i] + u
+ */
+double CubicSpline::pieceIntegral(size_t i, double u) const {
+    double u2 = u * u;
+    return y[i]*u + b[i]*u2/2.0 + c[i]*u2*u/3.0 + d[i]*u2*u2/4.0;
+}
+
 /**
  * Find crossings with horizontal line y = yVal
  * Uses sign change detection and bisection method refinement
@@ -0,0 +1,151 @@
+#include "CumulativeIntegral.h"
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+/**
+ * Integral over [p, q] of the quadratic through (x0,y0), (x1,y1), (x2,y2)
+ * Newton form: y0 + d1 (x-x0) + d2 (x-x0)(x-x1)
+ */
+double quadraticIntegral(double x0, double y0, double x1, double y1,
+                         double x2, double y2, double p, double q) {
+    double d1 = (y1 - y0) / (x1 - x0);
+    double d2 = ((y2 - y1) / (x2 - x1) - d1) / (x2 - x0);
+    
+    // Antiderivative in u = x - x0, using (x-x0)(x-x1) = u^2 + (x0-x1) u
+    auto G = [&](double u) {
+        return y0 * u + d1 * u * u / 2.0 + d2 * (u * u * u / 3.0 + (x0 - x1) * u * u / 2.0);
+    };
+    
+    return G(q - x0) - G(p - x0);
+}
+
+} // namespace
+
+/**
+ * Constructor
+ */
+CumulativeIntegral::CumulativeIntegral() : invStep(0.0), simpson(false), computed(false) {
+}
+
+/**
+ * Build prefix sums of per-interval integrals
+ */
+bool CumulativeIntegral::compute(const vector<double>& xData, const vector<double>& yData,
+                                 bool useSimpson) {
+    if (xData.size() != yData.size() || xData.size() < 2) {
+        cerr << "Error: Invalid data for cumulative integration" << endl;
+        return false;
+    }
+    
+    x = xData;
+    y = yData;
+    simpson = useSimpson;
+    computed = false;
+    
+    size_t n = x.size();
+    for (size_t i = 0; i < n - 1; i++) {
+        if (x[i+1] <= x[i]) {
+            cerr << "Error: x values must be strictly increasing" << endl;
+            return false;
+        }
+    }
+    
+    invStep = (n - 1) / (x[n-1] - x[0]);
+    
+    prefix.resize(n);
+    prefix[0] = 0.0;
+    for (size_t i = 0; i < n - 1; i++) {
+        prefix[i+1] = prefix[i] + partial(i, x[i+1]);
+    }
+    
+    computed = true;
+    return true;
+}
+
+/**
+ * Integrate from a to b as F(b) - F(a), F(t) = prefix[i] + partial(i, t)
+ */
+double CumulativeIntegral::integrate(double a, double b) const {
+    if (!computed) {
+        cerr << "Error: Cumulative integral not computed" << endl;
+        return 0.0;
+    }
+    
+    size_t ia = findInterval(a);
+    size_t ib = findInterval(b);
+    
+    double Fa = prefix[ia] + partial(ia, a);
+    double Fb = prefix[ib] + partial(ib, b);
+    
+    return Fb - Fa;
+}
+
+/**
+ * Locate interval by direct index on the average spacing, then correct;
+ * fall back to binary search if the grid is far from uniform
+ */
+size_t CumulativeIntegral::findInterval(double t) const {
+    size_t n = x.size();
+    
+    if (t <= x[0]) {
+        return 0;
+    }
+    if (t >= x[n-1]) {
+        return n - 2;
+    }
+    
+    size_t i = static_cast<size_t>((t - x[0]) * invStep);
+    if (i > n - 2) {
+        i = n - 2;
+    }
+    
+    // Allow a couple of steps of correction for rounding in the grid
+    for (int step = 0; step < 2; step++) {
+        if (x[i] > t) {
+            i--;
+        } else if (x[i+1] <= t) {
+            i++;
+        } else {
+            return i;
+        }
+    }
+    if (x[i] <= t && t < x[i+1]) {
+        return i;
+    }
+    
+    // Non-uniform grid - binary search
+    size_t hi = upper_bound(x.begin(), x.end(), t) - x.begin();
+    return hi - 1;
+}
+
+/**
+ * Integral over [x[i], t] within interval i
+ */
+double CumulativeIntegral::partial(size_t i, double t) const {
+    size_t n = x.size();
+    
+    if (!simpson || n < 3) {
+        // Trapezoid on the linear interpolant
+        double u = t - x[i];
+        double yt = y[i] + (y[i+1] - y[i]) * u / (x[i+1] - x[i]);
+        return u * (y[i] + yt) / 2.0;
+    }
+    
+    // Average the quadratics through (i-1, i, i+1) and (i, i+1, i+2)
+    double sum = 0.0;
+    int count = 0;
+    if (i >= 1) {
+        sum += quadraticIntegral(x[i-1], y[i-1], x[i], y[i], x[i+1], y[i+1], x[i], t);
+        count++;
+    }
+    if (i + 2 < n) {
+        sum += quadraticIntegral(x[i], y[i], x[i+1], y[i+1], x[i+2], y[i+2], x[i], t);
+        count++;
+    }
+    
+    return sum / count;
+}
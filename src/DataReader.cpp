@@ -1,6 +1,18 @@
 #include "DataReader.h"
+#include "Parallel.h"
+#include "SpectrumFile.h"
 #include <algorithm>
+#include <charconv>
 #include <cmath>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DATAREADER_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -13,47 +25,243 @@ DataReader::DataReader() {
 /**
  * Read data from file
  * @param filename - path to data file
+ * @param numThreads - parser threads (0 = all cores)
  * @return true if successful, false otherwise
  */
-bool DataReader::readFromFile(const string& filename) {
-    ifstream inFile(filename);
+bool DataReader::readFromFile(const string& filename, int numThreads) {
+    xData.clear();
+    yData.clear();
+    
+    int threads = Parallel::resolveThreads(numThreads);
+    if (SpectrumFile::isSpectrumFile(filename)) {
+        if (!readSpectrum(filename)) {
+            return false;
+        }
+    } else if (!(threads > 1 && readMapped(filename, threads)) && !readBlocks(filename)) {
+        return false;
+    }
+    
+    cout << "Read " << xData.size() << " data points from " << filename << endl;
+    
+    if (xData.empty()) {
+        cerr << "Error: No data points read from file" << endl;
+        return false;
+    }
+    
+    // Sort data by x-values in ascending order
+    sortData(threads);
+    
+    return true;
+}
+
+/**
+ * Load a binary spectrum file: the y column is copied out of the mapping
+ * in one block and x is either copied or generated from the grid
+ */
+bool DataReader::readSpectrum(const string& filename) {
+    SpectrumFile spectrum;
+    if (!spectrum.open(filename)) {
+        return false;
+    }
+    
+    size_t n = spectrum.size();
+    yData.assign(spectrum.yColumn(), spectrum.yColumn() + n);
+    if (spectrum.hasUniformGrid()) {
+        xData.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            xData[i] = spectrum.x(i);
+        }
+    } else {
+        xData.assign(spectrum.xColumn(), spectrum.xColumn() + n);
+    }
+    
+    return true;
+}
+
+/**
+ * Read the file in large blocks, parsing each in place with from_chars
+ * (no per-line string or stream); capacity is reserved up front from the
+ * file size and the line density of the first block
+ */
+bool DataReader::readBlocks(const string& filename) {
+    ifstream inFile(filename, ios::binary | ios::ate);
     
     if (!inFile.is_open()) {
         cerr << "Error: Cannot open data file: " << filename << endl;
         return false;
     }
     
-    xData.clear();
-    yData.clear();
+    streamoff length = inFile.tellg();
+    size_t fileSize = length > 0 ? static_cast<size_t>(length) : 0;
+    inFile.seekg(0);
     
-    string line;
-    double x, y;
+    vector<char> buffer(readBlockSize);
+    size_t carried = 0;
+    bool first = true;
     
-    while (getline(inFile, line)) {
-        // Skip empty lines and comments
-        if (line.empty() || line[0] == '#') {
-            continue;
+    while (true) {
+        // Grow the buffer if a single line is longer than the block
+        if (carried == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        inFile.read(buffer.data() + carried, buffer.size() - carried);
+        size_t filled = carried + static_cast<size_t>(inFile.gcount());
+        bool atEnd = filled < buffer.size();
+        
+        if (first) {
+            size_t lines = count(buffer.data(), buffer.data() + filled, '\n') + 1;
+            size_t estimate = filled > 0
+                ? static_cast<size_t>(static_cast<double>(lines) * fileSize / filled) + 16 : 0;
+            xData.reserve(estimate);
+            yData.reserve(estimate);
+            first = false;
         }
         
-        istringstream iss(line);
-        if (iss >> x >> y) {
-            xData.push_back(x);
-            yData.push_back(y);
+        const char* rest = parseLines(buffer.data(), buffer.data() + filled, atEnd,
+                                      xData, yData);
+        if (atEnd) {
+            break;
         }
+        
+        // Move the unterminated last line to the front for the next block
+        carried = static_cast<size_t>(buffer.data() + filled - rest);
+        copy(rest, static_cast<const char*>(buffer.data() + filled), buffer.data());
     }
     
     inFile.close();
+    return true;
+}
+
+/**
+ * Map the whole file and parse it on several threads
+ * 
+ * The file is cut into chunks of about equal size, each boundary moved
+ * forward to just past a newline, so every line belongs to exactly one
+ * chunk. Chunks are parsed into their own buffers and copied out in
+ * file order, so the result is the same as a sequential read.
+ */
+bool DataReader::readMapped(const string& filename, int numThreads) {
+#ifdef DATAREADER_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < parallelParseMinBytes) {
+        close(fd);
+        return false;
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapping, fileSize, MADV_SEQUENTIAL);
     
-    cout << "Read " << xData.size() << " data points from " << filename << endl;
+    const char* text = static_cast<const char*>(mapping);
+    const char* end = text + fileSize;
     
-    if (xData.empty()) {
-        cerr << "Error: No data points read from file" << endl;
+    // Several chunks per thread so uneven lines still balance
+    size_t numChunks = static_cast<size_t>(numThreads) * 4;
+    vector<const char*> bounds(numChunks + 1, end);
+    bounds[0] = text;
+    for (size_t c = 1; c < numChunks; c++) {
+        const char* cut = max(bounds[c - 1], text + fileSize / numChunks * c);
+        const char* newline = static_cast<const char*>(memchr(cut, '\n', end - cut));
+        bounds[c] = newline ? newline + 1 : end;
+    }
+    
+    vector<vector<double>> chunkX(numChunks);
+    vector<vector<double>> chunkY(numChunks);
+    Parallel::forEach(numChunks, numThreads, [&](size_t c) {
+        size_t bytes = static_cast<size_t>(bounds[c + 1] - bounds[c]);
+        size_t estimate = bytes / 16 + 16;
+        chunkX[c].reserve(estimate);
+        chunkY[c].reserve(estimate);
+        parseLines(bounds[c], bounds[c + 1], true, chunkX[c], chunkY[c]);
+    });
+    munmap(mapping, fileSize);
+    
+    vector<size_t> offsets(numChunks + 1, 0);
+    for (size_t c = 0; c < numChunks; c++) {
+        offsets[c + 1] = offsets[c] + chunkX[c].size();
+    }
+    xData.resize(offsets[numChunks]);
+    yData.resize(offsets[numChunks]);
+    Parallel::forEach(numChunks, numThreads, [&](size_t c) {
+        copy(chunkX[c].begin(), chunkX[c].end(), xData.begin() + offsets[c]);
+        copy(chunkY[c].begin(), chunkY[c].end(), yData.begin() + offsets[c]);
+        vector<double>().swap(chunkX[c]);
+        vector<double>().swap(chunkY[c]);
+    });
+    
+    cout << "Parsed " << fileSize << " bytes in " << numChunks << " chunks on "
+              << numThreads << " threads" << endl;
+    return true;
+#else
+    (void)filename;
+    (void)numThreads;
+    return false;
+#endif
+}
+
+/**
+ * Parse the lines of one block
+ */
+const char* DataReader::parseLines(const char* begin, const char* end, bool atEnd,
+                                   vector<double>& x, vector<double>& y) {
+    const char* line = begin;
+    while (line < end) {
+        const char* newline = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (newline == nullptr) {
+            if (!atEnd) {
+                return line;
+            }
+            newline = end;
+        }
+        
+        double xValue, yValue;
+        if (parseLine(line, newline, xValue, yValue)) {
+            x.push_back(xValue);
+            y.push_back(yValue);
+        }
+        line = newline + 1;
+    }
+    return end;
+}
+
+/**
+ * Parse one line with the same rules as the old stream reader:
+ * skip empty lines and lines starting with '#', then read two
+ * whitespace-separated numbers (anything after them is ignored)
+ */
+bool DataReader::parseLine(const char* begin, const char* end, double& x, double& y) {
+    // Skip empty lines and comments
+    if (begin == end || *begin == '#') {
         return false;
     }
     
-    // Sort data by x-values in ascending order
-    sortData();
+    auto isSpace = [](char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    };
     
+    const char* p = begin;
+    double* targets[2] = {&x, &y};
+    for (double* target : targets) {
+        while (p < end && isSpace(*p)) {
+            p++;
+        }
+        // from_chars does not take a leading '+', the stream reader did
+        if (p < end && *p == '+') {
+            p++;
+        }
+        from_chars_result result = from_chars(p, end, *target);
+        if (result.ec != errc()) {
+            return false;
+        }
+        p = result.ptr;
+    }
     return true;
 }
 
@@ -74,41 +282,83 @@ void DataReader::print(size_t numPoints) const {
  * Sort data by x-values in ascending order
  * For cubic spline interpolation
  * Keeps x,y pairs together during sorting
+ * 
+ * Spectrometer exports usually list x in descending ppm order, so a
+ * strictly descending input is simply reversed in O(n). Anything else is
+ * sorted as (x, y) pairs in one contiguous array; large inputs are sorted
+ * in per-thread runs that are then merged pairwise.
+ * @param numThreads - sort threads (0 = all cores; default 1)
  */
-void DataReader::sortData() {
+void DataReader::sortData(int numThreads) {
     if (xData.size() != yData.size() || xData.empty()) {
         return;
     }
     
-    // Check if already sorted
-    if (isSorted()) {
+    // One scan tells ascending, strictly descending and unsorted apart
+    bool ascending = true;
+    bool descending = true;
+    for (size_t i = 1; i < xData.size() && (ascending || descending); i++) {
+        if (xData[i] < xData[i-1]) {
+            ascending = false;
+        }
+        if (!(xData[i] < xData[i-1])) {
+            descending = false;
+        }
+    }
+    
+    if (ascending) {
         cout << "Data is already sorted in ascending order" << endl;
         return;
     }
     
-    // Create vector of indices
-    vector<size_t> indices(xData.size());
-    for (size_t i = 0; i < indices.size(); i++) {
-        indices[i] = i;
+    if (descending) {
+        reverse(xData.begin(), xData.end());
+        reverse(yData.begin(), yData.end());
+        cout << "Data reversed into ascending order by x-values" << endl;
+        return;
     }
     
-    // Sort indices based on x-values
-    sort(indices.begin(), indices.end(),
-              [this](size_t i1, size_t i2) { return xData[i1] < xData[i2]; });
+    size_t n = xData.size();
+    vector<pair<double, double>> points(n);
+    for (size_t i = 0; i < n; i++) {
+        points[i] = make_pair(xData[i], yData[i]);
+    }
     
-    // Create temporary copies
-    vector<double> sortedX(xData.size());
-    vector<double> sortedY(yData.size());
+    auto byX = [](const pair<double, double>& a, const pair<double, double>& b) {
+        return a.first < b.first;
+    };
     
-    // Reorder data using sorted indices
-    for (size_t i = 0; i < indices.size(); i++) {
-        sortedX[i] = xData[indices[i]];
-        sortedY[i] = yData[indices[i]];
+    int threads = Parallel::resolveThreads(numThreads);
+    if (threads > 1 && n >= parallelSortMinPoints) {
+        // Sort one run per thread, then merge neighbouring runs level by level
+        size_t runs = static_cast<size_t>(threads);
+        vector<size_t> bounds(runs + 1);
+        for (size_t r = 0; r <= runs; r++) {
+            bounds[r] = n * r / runs;
+        }
+        Parallel::forEach(runs, threads, [&](size_t r) {
+            sort(points.begin() + bounds[r], points.begin() + bounds[r + 1], byX);
+        });
+        for (size_t width = 1; width < runs; width *= 2) {
+            size_t merges = (runs + 2 * width - 1) / (2 * width);
+            Parallel::forEach(merges, threads, [&](size_t m) {
+                size_t first = 2 * width * m;
+                size_t middle = min(first + width, runs);
+                size_t last = min(first + 2 * width, runs);
+                if (middle < last) {
+                    inplace_merge(points.begin() + bounds[first], points.begin() + bounds[middle],
+                                  points.begin() + bounds[last], byX);
+                }
+            });
+        }
+    } else {
+        sort(points.begin(), points.end(), byX);
     }
     
-    // Replace original data with sorted data
-    xData = sortedX;
-    yData = sortedY;
+    for (size_t i = 0; i < n; i++) {
+        xData[i] = points[i].first;
+        yData[i] = points[i].second;
+    }
     
     cout << "Data sorted in ascending order by x-values" << endl;
 }
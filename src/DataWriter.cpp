@@ -39,6 +39,47 @@ bool DataWriter::writeData(const string& filename,
     return true;
 }
 
+/**
+ * Write x and several y columns to file
+ */
+bool DataWriter::writeColumns(const string& filename,
+                              const vector<double>& xData,
+                              const vector<vector<double>>& columns,
+                              const string& header) {
+    for (const vector<double>& column : columns) {
+        if (column.size() != xData.size()) {
+            cerr << "Error: column sizes don't match x data" << endl;
+            return false;
+        }
+    }
+    
+    ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        cerr << "Error: Cannot open output file: " << filename << endl;
+        return false;
+    }
+    
+    // Write header if provided
+    if (!header.empty()) {
+        outFile << "# " << header << endl;
+    }
+    
+    // Write data
+    outFile << fixed << setprecision(6);
+    for (size_t i = 0; i < xData.size(); i++) {
+        outFile << xData[i];
+        for (const vector<double>& column : columns) {
+            outFile << " " << column[i];
+        }
+        outFile << endl;
+    }
+    
+    outFile.close();
+    cout << "Data written to: " << filename << " (" << xData.size() << " points, "
+              << columns.size() << " columns)" << endl;
+    return true;
+}
+
 /**
  * Write spline-evaluated data
  */
@@ -77,7 +118,8 @@ bool DataWriter::writeSplineData(const string& filename,
  */
 bool DataWriter::writePeakData(const string& filename,
                               const vector<Peak>& peaks,
-                              double baseline) {
+                              double baseline,
+                              bool showStats) {
     ofstream outFile(filename);
     if (!outFile.is_open()) {
         cerr << "Error: Cannot open output file: " << filename << endl;
@@ -85,7 +127,11 @@ bool DataWriter::writePeakData(const string& filename,
     }
     
     outFile << "# Peak data for plotting" << endl;
-    outFile << "# Format: peak_number, begin, end, location, maximum, area, hydrogens" << endl;
+    outFile << "# Format: peak_number, begin, end, location, maximum, area, hydrogens";
+    if (showStats) {
+        outFile << ", method, evaluations, levels, converged, error_estimate";
+    }
+    outFile << endl;
     outFile << "# Baseline: " << baseline << endl;
     outFile << fixed << setprecision(12);
     
@@ -96,7 +142,15 @@ bool DataWriter::writePeakData(const string& filename,
                 << peaks[i].location << " "
                 << peaks[i].maximum << " "
                 << scientific << peaks[i].area << " "
-                << fixed << peaks[i].hydrogens << endl;
+                << fixed << peaks[i].hydrogens;
+        if (showStats) {
+            outFile << " " << (peaks[i].method.empty() ? "-" : peaks[i].method)
+                    << " " << peaks[i].stats.evaluations
+                    << " " << peaks[i].stats.levels
+                    << " " << (peaks[i].stats.converged ? 1 : 0)
+                    << " " << scientific << peaks[i].stats.errorEstimate << fixed;
+        }
+        outFile << endl;
     }
     
     outFile.close();
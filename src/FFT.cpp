@@ -0,0 +1,91 @@
+#include "FFT.h"
+#include <cmath>
+#include <utility>
+
+using namespace std;
+
+/**
+ * Constructor - precompute twiddles and the bit-reversal permutation
+ */
+FFT::FFT(size_t size) : n(size), twiddles(size / 2), bitReverse(size) {
+    const double pi = 3.14159265358979323846;
+
+    for (size_t k = 0; k < n / 2; k++) {
+        double angle = -2.0 * pi * static_cast<double>(k) / static_cast<double>(n);
+        twiddles[k] = complex<double>(cos(angle), sin(angle));
+    }
+
+    int bits = 0;
+    while ((static_cast<size_t>(1) << bits) < n) {
+        bits++;
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            if (i & (static_cast<size_t>(1) << b)) {
+                reversed |= static_cast<size_t>(1) << (bits - 1 - b);
+            }
+        }
+        bitReverse[i] = reversed;
+    }
+}
+
+/**
+ * Forward transform
+ */
+void FFT::forward(complex<double>* data) const {
+    transform(data, false);
+}
+
+/**
+ * Inverse transform (scaled by 1/n)
+ */
+void FFT::inverse(complex<double>* data) const {
+    transform(data, true);
+    double scale = 1.0 / static_cast<double>(n);
+    for (size_t i = 0; i < n; i++) {
+        data[i] *= scale;
+    }
+}
+
+/**
+ * Iterative decimation-in-time butterflies
+ * The inverse uses conjugated twiddles. Products are written out by hand
+ * because complex<double>::operator* goes through the slow NaN-checking
+ * library routine
+ */
+void FFT::transform(complex<double>* data, bool inverse) const {
+    for (size_t i = 0; i < n; i++) {
+        if (i < bitReverse[i]) {
+            swap(data[i], data[bitReverse[i]]);
+        }
+    }
+
+    for (size_t length = 2; length <= n; length *= 2) {
+        size_t half = length / 2;
+        size_t stride = n / length;
+        for (size_t start = 0; start < n; start += length) {
+            for (size_t k = 0; k < half; k++) {
+                double wr = twiddles[k * stride].real();
+                double wi = inverse ? -twiddles[k * stride].imag() : twiddles[k * stride].imag();
+                complex<double>& upper = data[start + k];
+                complex<double>& lower = data[start + k + half];
+                complex<double> t(wr * lower.real() - wi * lower.imag(),
+                                  wr * lower.imag() + wi * lower.real());
+                lower = upper - t;
+                upper += t;
+            }
+        }
+    }
+}
+
+/**
+ * Smallest power of two >= value
+ */
+size_t FFT::nextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
@@ -1,5 +1,16 @@
 #include "Filter.h"
+#include "Convolution.h"
+#include "FFT.h"
+#include "Parallel.h"
+#include "SavitzkyGolay.h"
+#include "StreamingFilter.h"
+#include "Wavelet.h"
+#include "Whittaker.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <set>
 
 using namespace std;
 
@@ -7,16 +18,323 @@ using namespace std;
  * Apply boxcar filter multiple times
  */
 vector<double> Filter::applyBoxcar(const vector<double>& data, 
-                                       int filterSize, int numPasses) {
+                                       int filterSize, int numPasses, int numThreads,
+                                       int backend) {
     cout << "Applying " << numPasses << "-pass boxcar filter (size " 
               << filterSize << ")..." << endl;
     
-    vector<double> result = data;
+    vector<double> result(data.size());
+    int threads = Parallel::resolveThreads(numThreads);
+    if (filterSize > 0 && numPasses > 0 &&
+        useFFT(backend, data.size(), (filterSize - 1) / 2, numPasses, true)) {
+        vector<double> kernel(filterSize, 1.0 / filterSize);
+        fftPasses(data.data(), result.data(), data.size(), kernel.data(), (filterSize - 1) / 2,
+                  numPasses, threads);
+    } else if (threads > 1 && data.size() > filterTileSize && filterSize > 0 && numPasses > 0) {
+        cout << "  Tiled over " << threads << " threads (" << filterTileSize
+                  << "-point tiles)" << endl;
+        size_t n = data.size();
+        runPassesTiled(data.data(), result.data(), n, numPasses, (filterSize - 1) / 2,
+                       boxcarReseedInterval, threads,
+                       [n, filterSize](const double* in, double* out, size_t base,
+                                       size_t begin, size_t end) {
+                           boxcarPassRange(in, out, n, base, begin, end, filterSize);
+                       });
+    } else {
+        vector<double> scratch(data.size());
+        applyBoxcar(data.data(), result.data(), data.size(), filterSize, numPasses,
+                    scratch.data());
+    }
+    
+    cout << "  " << numPasses << " passes complete" << endl;
+    
+    return result;
+}
+
+/**
+ * Boxcar filter into a destination buffer, ping-ponging with scratch
+ */
+void Filter::applyBoxcar(const double* data, double* dest, size_t n,
+                         int filterSize, int numPasses, double* scratch) {
+    if (filterSize <= 0) {
+        numPasses = 0;
+    }
+    runPasses(data, dest, n, numPasses, scratch,
+              [filterSize](const double* in, double* out, size_t count) {
+                  boxcarPassInto(in, out, count, filterSize);
+              });
+}
+
+/**
+ * Boxcar filter in place, swapping data with scratch when needed
+ */
+void Filter::applyBoxcarInPlace(vector<double>& data, int filterSize, int numPasses,
+                                vector<double>& scratch) {
+    if (filterSize <= 0) {
+        return;
+    }
+    runPassesInPlace(data, numPasses, scratch,
+                     [filterSize](const double* in, double* out, size_t count) {
+                         boxcarPassInto(in, out, count, filterSize);
+                     });
+}
+
+/**
+ * Run numPasses of a pass kernel, alternating between dest and scratch
+ * The first target is chosen so the last pass lands in dest
+ */
+void Filter::runPasses(const double* data, double* dest, size_t n, int numPasses,
+                       double* scratch, const PassKernel& kernel) {
+    if (numPasses <= 0 || n == 0) {
+        if (dest != data) {
+            copy(data, data + n, dest);
+        }
+        return;
+    }
+    
+    // In place with an odd pass count the first pass would write over its
+    // own input, so start from a copy in scratch instead
+    if (data == dest && numPasses % 2 == 1) {
+        copy(data, data + n, scratch);
+        data = scratch;
+    }
+    
+    const double* in = data;
+    double* out = (numPasses % 2 == 1) ? dest : scratch;
+    double* other = (numPasses % 2 == 1) ? scratch : dest;
+    
+    for (int pass = 0; pass < numPasses; pass++) {
+        kernel(in, out, n);
+        in = out;
+        swap(out, other);
+    }
+}
+
+/**
+ * Run numPasses over cache-sized tiles in parallel
+ * 
+ * Each tile is widened by a halo of halfWidth points per remaining pass
+ * (rounded down to the kernel's alignment), copied into two local
+ * buffers, and taken through every pass while it is still in cache.
+ * Pass p only computes the range pass p+1 will read, so the halo
+ * shrinks pass by pass. Every output is computed from the same inputs
+ * in the same order as the serial sweep, so the result is identical.
+ */
+void Filter::runPassesTiled(const double* data, double* dest, size_t n, int numPasses,
+                            int halfWidth, size_t alignment, int numThreads,
+                            const RangeKernel& kernel) {
+    size_t k = static_cast<size_t>(halfWidth);
+    size_t tileCount = (n + filterTileSize - 1) / filterTileSize;
+    
+    Parallel::forEach(tileCount, numThreads, [&](size_t tile) {
+        // Range [lo[p], hi[p]) needed from pass p (p = 0 is the input)
+        vector<size_t> lo(numPasses + 1);
+        vector<size_t> hi(numPasses + 1);
+        lo[numPasses] = tile * filterTileSize;
+        hi[numPasses] = min(n, lo[numPasses] + filterTileSize);
+        for (int p = numPasses - 1; p >= 0; p--) {
+            size_t start = lo[p + 1] > k ? lo[p + 1] - k : 0;
+            lo[p] = (p > 0) ? start / alignment * alignment : start;
+            hi[p] = min(n, hi[p + 1] + k);
+        }
+        
+        size_t base = lo[0];
+        vector<double> current(data + base, data + hi[0]);
+        vector<double> next(current.size());
+        for (int p = 1; p <= numPasses; p++) {
+            kernel(current.data(), next.data(), base, lo[p], hi[p]);
+            current.swap(next);
+        }
+        
+        copy(current.begin() + (lo[numPasses] - base), current.begin() + (hi[numPasses] - base),
+             dest + lo[numPasses]);
+    });
+}
+
+/**
+ * Decide between direct passes and the FFT path
+ * 
+ * Estimated cost in nanoseconds per point (measured on an AVX-512 machine):
+ * - direct boxcar: 5 per pass (compensated running sum, any width)
+ * - direct SG:     1.5 + 0.15 (halfWidth + 1) per pass
+ * - FFT:           4 M log2(M) per forward/inverse pair of size M, shared
+ *                  by two blocks of M - 2 passes halfWidth outputs
+ */
+bool Filter::useFFT(int backend, size_t n, int halfWidth, int numPasses, bool boxcar) {
+    if (backend == 1 || n < static_cast<size_t>(2 * halfWidth + 2)) {
+        if (backend == 2) {
+            cerr << "Warning: FFT filtering needs more points than the window. "
+                 << "Using direct passes." << endl;
+        }
+        return false;
+    }
+    
+    size_t compositeHalfWidth = static_cast<size_t>(numPasses) * halfWidth;
+    size_t blockSize = fftBlockSize(compositeHalfWidth);
+    double step = static_cast<double>(blockSize - 2 * compositeHalfWidth);
+    double fftCost = 4.0 * blockSize * log2(static_cast<double>(blockSize)) / (2.0 * step);
+    double directCost = boxcar ? 5.0 * numPasses
+                               : (1.5 + 0.15 * (halfWidth + 1)) * numPasses;
+    
+    bool chooseFFT = (backend == 2) || (backend == 0 && fftCost < directCost);
+    if (chooseFFT) {
+        cout << "  FFT backend: " << numPasses << "-pass composite kernel of "
+                  << (2 * compositeHalfWidth + 1) << " taps, " << blockSize
+                  << "-point overlap-save blocks" << endl;
+    }
+    return chooseFFT;
+}
+
+/**
+ * FFT block size for a composite kernel: at least 4x the kernel width
+ * so most of each block is usable output
+ */
+size_t Filter::fftBlockSize(size_t compositeHalfWidth) {
+    return FFT::nextPowerOfTwo(max(static_cast<size_t>(1024), 8 * compositeHalfWidth + 4));
+}
+
+/**
+ * Apply numPasses of a symmetric kernel with one FFT convolution
+ * 
+ * Reflecting at the boundaries before every pass is the same as filtering
+ * the mirror-periodic extension of the data (period 2n - 2), because a
+ * symmetric kernel keeps that symmetry. All passes therefore collapse into
+ * one convolution whose transfer function is the single-pass transfer
+ * function raised to the power numPasses. The convolution runs as
+ * overlap-save over power-of-two blocks; the kernel is symmetric, so its
+ * transfer function is real and two real blocks are filtered per complex
+ * transform (one in the real part, one in the imaginary part).
+ */
+void Filter::fftPasses(const double* data, double* dest, size_t n, const double* kernel,
+                       int halfWidth, int numPasses, int numThreads) {
+    size_t h = static_cast<size_t>(numPasses) * halfWidth;
+    size_t blockSize = fftBlockSize(h);
+    size_t step = blockSize - 2 * h;
+    FFT fft(blockSize);
+    
+    // Single-pass transfer function (kernel centred on index 0)
+    vector<complex<double>> single(blockSize);
+    single[0] = kernel[halfWidth];
+    for (int j = 1; j <= halfWidth; j++) {
+        single[j] = kernel[halfWidth + j];
+        single[blockSize - j] = kernel[halfWidth + j];
+    }
+    fft.forward(single.data());
+    
+    vector<double> transfer(blockSize);
+    for (size_t i = 0; i < blockSize; i++) {
+        double value = 1.0;
+        for (int pass = 0; pass < numPasses; pass++) {
+            value *= single[i].real();
+        }
+        transfer[i] = value;
+    }
+    
+    // Sample of the mirror-periodic extension at any index
+    long long period = 2 * static_cast<long long>(n) - 2;
+    auto sample = [&](long long t) {
+        long long r = t % period;
+        if (r < 0) {
+            r += period;
+        }
+        if (r >= static_cast<long long>(n)) {
+            r = period - r;
+        }
+        return data[r];
+    };
+    
+    size_t blockCount = (n + step - 1) / step;
+    size_t pairCount = (blockCount + 1) / 2;
+    
+    Parallel::forEach(pairCount, numThreads, [&](size_t pair) {
+        vector<complex<double>> buffer(blockSize);
+        size_t first = 2 * pair;
+        size_t second = first + 1;
+        long long firstStart = static_cast<long long>(first * step) - static_cast<long long>(h);
+        long long secondStart = firstStart + static_cast<long long>(step);
+        bool hasSecond = second < blockCount;
+        
+        for (size_t i = 0; i < blockSize; i++) {
+            long long offset = static_cast<long long>(i);
+            buffer[i] = complex<double>(sample(firstStart + offset),
+                                        hasSecond ? sample(secondStart + offset) : 0.0);
+        }
+        
+        fft.forward(buffer.data());
+        for (size_t i = 0; i < blockSize; i++) {
+            buffer[i] *= transfer[i];
+        }
+        fft.inverse(buffer.data());
+        
+        // Outputs h .. h+step-1 of each block saw no circular wrap-around
+        for (size_t i = 0; i < step && first * step + i < n; i++) {
+            dest[first * step + i] = buffer[h + i].real();
+        }
+        if (hasSecond) {
+            for (size_t i = 0; i < step && second * step + i < n; i++) {
+                dest[second * step + i] = buffer[h + i].imag();
+            }
+        }
+    });
+}
+
+/**
+ * Run numPasses of a pass kernel in place on data
+ * Ends with a vector swap (no copy) if the last pass wrote scratch
+ */
+void Filter::runPassesInPlace(vector<double>& data, int numPasses,
+                              vector<double>& scratch, const PassKernel& kernel) {
+    if (numPasses <= 0 || data.empty()) {
+        return;
+    }
+    if (scratch.size() < data.size()) {
+        scratch.resize(data.size());
+    }
+    
+    size_t n = data.size();
+    double* in = data.data();
+    double* out = scratch.data();
     for (int pass = 0; pass < numPasses; pass++) {
-        result = boxcarPass(result, filterSize);
-        cout << "  Pass " << (pass + 1) << " complete" << endl;
+        kernel(in, out, n);
+        swap(in, out);
     }
     
+    // A larger caller scratch keeps its extra length out of the result
+    if (in != data.data()) {
+        data.swap(scratch);
+        data.resize(n);
+    }
+}
+
+/**
+ * Apply multi-pass boxcar filter in one sweep over memory
+ */
+vector<double> Filter::applyBoxcarFused(const vector<double>& data,
+                                        int filterSize, int numPasses) {
+    return applyFused(data, 1, filterSize, numPasses);
+}
+
+/**
+ * Apply a multi-pass filter in one sweep over memory
+ * Each pass is a StreamingFilter stage feeding the next chunk by chunk,
+ * so intermediate passes stay in cache and never touch a full-length array
+ */
+vector<double> Filter::applyFused(const vector<double>& data, int filterType,
+                                  int filterSize, int numPasses, int polyOrder) {
+    const char* names[] = {"none", "boxcar", "Savitzky-Golay", "median"};
+    cout << "Applying " << numPasses << "-pass "
+              << names[(filterType >= 1 && filterType <= 3) ? filterType : 0]
+              << " filter (size " << filterSize << ", fused)..." << endl;
+    
+    vector<double> result;
+    result.reserve(data.size());
+    
+    StreamingFilter stream(filterType, filterSize, numPasses, polyOrder);
+    stream.push(data, result);
+    stream.finish(result);
+    
+    cout << "  " << numPasses << " passes complete" << endl;
+    
     return result;
 }
 
@@ -25,143 +343,606 @@ vector<double> Filter::applyBoxcar(const vector<double>& data,
  * 
  * Formula: B(yi) = sum(y[i-k]...y[i]...y[i+k]) / n
  * where k = (n-1)/2 and boundaries wrap around cyclically
+ * 
+ * Implemented as a sliding window with a compensated running sum.
+ * Each step adds the entering sample and subtracts the leaving one, so
+ * the cost is O(n) for any window. The sum uses Neumaier compensation
+ * and is re-seeded directly every boxcarReseedInterval outputs (aligned
+ * to the global index) so rounding cannot drift over long spectra.
+ * 
+ * The three index regions get their own loops so no reflection test
+ * runs per sample:
+ * - left edge  (i <= k):      leaving sample mirrors to y[k + 1 - i]
+ * - interior:                 no reflection
+ * - right edge (i + k >= n):  entering sample mirrors to y[2n - 2 - i - k]
+ */
+void Filter::boxcarPassInto(const double* in, double* out, size_t n, int filterSize) {
+    boxcarPassRange(in, out, n, 0, 0, n, filterSize);
+}
+
+/**
+ * Boxcar outputs [begin, end) of an n-point pass
+ * in and out hold points [base, ...); begin must be 0 or a multiple of
+ * boxcarReseedInterval so the running sums match the full-length pass
+ */
+void Filter::boxcarPassRange(const double* in, double* out, size_t n, size_t base,
+                             size_t begin, size_t end, int filterSize) {
+    int halfWidth = (filterSize - 1) / 2;
+    size_t k = static_cast<size_t>(halfWidth);
+    
+    // Windows wider than the data need repeated reflection - use direct sums
+    if (n < 2 * k + 2) {
+        for (size_t i = begin; i < end; i++) {
+            double sum = 0.0;
+            for (int j = -halfWidth; j <= halfWidth; j++) {
+                sum += in[Convolution::reflectIndex(static_cast<int>(i) + j,
+                                                    static_cast<int>(n)) - base];
+            }
+            out[i - base] = sum / filterSize;
+        }
+        return;
+    }
+    
+    for (size_t blockStart = begin; blockStart < end; blockStart += boxcarReseedInterval) {
+        size_t blockEnd = min(end, blockStart + boxcarReseedInterval);
+        
+        // Seed the window sum directly at the start of the block
+        double sum = 0.0;
+        double comp = 0.0;
+        for (int j = -halfWidth; j <= halfWidth; j++) {
+            neumaierAdd(sum, comp, in[Convolution::reflectIndex(static_cast<int>(blockStart) + j,
+                                                                static_cast<int>(n)) - base]);
+        }
+        out[blockStart - base] = (sum + comp) / filterSize;
+        
+        size_t i = blockStart + 1;
+        
+        // Left edge: leaving sample is reflected
+        for (size_t stop = min(blockEnd, k + 1); i < stop; i++) {
+            neumaierAdd(sum, comp, in[i + k - base]);
+            neumaierAdd(sum, comp, -in[k + 1 - i - base]);
+            out[i - base] = (sum + comp) / filterSize;
+        }
+        
+        // Interior: no reflection
+        for (size_t stop = min(blockEnd, n - k); i < stop; i++) {
+            neumaierAdd(sum, comp, in[i + k - base]);
+            neumaierAdd(sum, comp, -in[i - k - 1 - base]);
+            out[i - base] = (sum + comp) / filterSize;
+        }
+        
+        // Right edge: entering sample is reflected
+        for (; i < blockEnd; i++) {
+            neumaierAdd(sum, comp, in[2 * n - 2 - i - k - base]);
+            neumaierAdd(sum, comp, -in[i - k - 1 - base]);
+            out[i - base] = (sum + comp) / filterSize;
+        }
+    }
+}
+
+/**
+ * Apply Savitzky-Golay filter multiple times
+ */
+vector<double> Filter::applySavitzkyGolay(const vector<double>& data, 
+                                              int filterSize, int numPasses, int polyOrder,
+                                              int numThreads, int backend) {
+    cout << "Applying " << numPasses << "-pass Savitzky-Golay filter (size " 
+              << filterSize << ", order " << polyOrder << ", "
+              << Convolution::kernelName() << " kernel)..." << endl;
+    
+    vector<double> result(data.size());
+    int threads = Parallel::resolveThreads(numThreads);
+    if (numPasses > 0 && useFFT(backend, data.size(), (filterSize - 1) / 2, numPasses, false)) {
+        const double* coeffs = sgCoefficients(filterSize, polyOrder);
+        fftPasses(data.data(), result.data(), data.size(), coeffs, (filterSize - 1) / 2,
+                  numPasses, threads);
+    } else if (threads > 1 && data.size() > filterTileSize && numPasses > 0) {
+        cout << "  Tiled over " << threads << " threads (" << filterTileSize
+                  << "-point tiles)" << endl;
+        const double* coeffs = sgCoefficients(filterSize, polyOrder);
+        int halfWidth = (filterSize - 1) / 2;
+        size_t n = data.size();
+        runPassesTiled(data.data(), result.data(), n, numPasses, halfWidth, 1, threads,
+                       [n, coeffs, halfWidth](const double* in, double* out, size_t base,
+                                              size_t begin, size_t end) {
+                           Convolution::symmetric(in, out, n, base, begin, end,
+                                                  coeffs, halfWidth);
+                       });
+    } else {
+        vector<double> scratch(data.size());
+        applySavitzkyGolay(data.data(), result.data(), data.size(), filterSize, numPasses,
+                           scratch.data(), polyOrder);
+    }
+    
+    cout << "  " << numPasses << " passes complete" << endl;
+    
+    return result;
+}
+
+/**
+ * Savitzky-Golay filter into a destination buffer, ping-ponging with scratch
+ */
+void Filter::applySavitzkyGolay(const double* data, double* dest, size_t n,
+                                int filterSize, int numPasses, double* scratch,
+                                int polyOrder) {
+    const double* coeffs = sgCoefficients(filterSize, polyOrder);
+    int halfWidth = (filterSize - 1) / 2;
+    runPasses(data, dest, n, numPasses, scratch,
+              [coeffs, halfWidth](const double* in, double* out, size_t count) {
+                  sgPassInto(in, out, count, coeffs, halfWidth);
+              });
+}
+
+/**
+ * Savitzky-Golay filter in place, swapping data with scratch when needed
+ */
+void Filter::applySavitzkyGolayInPlace(vector<double>& data, int filterSize, int numPasses,
+                                       vector<double>& scratch, int polyOrder) {
+    const double* coeffs = sgCoefficients(filterSize, polyOrder);
+    int halfWidth = (filterSize - 1) / 2;
+    runPassesInPlace(data, numPasses, scratch,
+                     [coeffs, halfWidth](const double* in, double* out, size_t count) {
+                         sgPassInto(in, out, count, coeffs, halfWidth);
+                     });
+}
+
+/**
+ * Savitzky-Golay smoothing with first and second derivatives
+ * The first numPasses - 1 passes only smooth; the last pass evaluates the
+ * smoothing and both derivative kernels from the same window loads
  */
-vector<double> Filter::boxcarPass(const vector<double>& data, int filterSize) {
-    if (filterSize <= 0 || data.empty()) {
-        return data;
+bool Filter::applySavitzkyGolayDerivatives(const vector<double>& data, int filterSize,
+                                           int numPasses, int polyOrder, double spacing,
+                                           vector<double>& smoothed,
+                                           vector<double>& firstDerivative,
+                                           vector<double>& secondDerivative) {
+    if (spacing == 0.0) {
+        cerr << "Error: Sample spacing for SG derivatives must be non-zero" << endl;
+        return false;
+    }
+    if (numPasses < 1) {
+        numPasses = 1;
+    }
+    
+    const double* c0 = sgCoefficients(filterSize, polyOrder);
+    cout << "Computing Savitzky-Golay derivatives (size " << filterSize << ", order "
+              << polyOrder << ", " << numPasses << " passes)..." << endl;
+    if (polyOrder < 2) {
+        cerr << "Warning: SG polynomial order " << polyOrder
+             << " has no curvature term; second derivative will be zero" << endl;
+    }
+    
+    // Derivative kernels scaled from per-sample to per-x-unit
+    int halfWidth = (filterSize - 1) / 2;
+    const double* unit1 = SavitzkyGolay::coefficients(filterSize, polyOrder, 1);
+    const double* unit2 = SavitzkyGolay::coefficients(filterSize, polyOrder, 2);
+    vector<double> c1(filterSize);
+    vector<double> c2(filterSize);
+    for (int j = 0; j < filterSize; j++) {
+        c1[j] = unit1[j] / spacing;
+        c2[j] = unit2[j] / (spacing * spacing);
     }
     
     size_t n = data.size();
-    vector<double> result(n);
+    smoothed.resize(n);
+    firstDerivative.resize(n);
+    secondDerivative.resize(n);
+    
+    // Earlier passes (firstDerivative is free to use as scratch until the last pass)
+    const double* input = data.data();
+    vector<double> previous;
+    if (numPasses > 1) {
+        previous.resize(n);
+        applySavitzkyGolay(data.data(), previous.data(), n, filterSize, numPasses - 1,
+                           firstDerivative.data(), polyOrder);
+        input = previous.data();
+    }
+    
+    Convolution::smoothAndDerivatives(input, smoothed.data(), firstDerivative.data(),
+                                      secondDerivative.data(), n, c0, c1.data(), c2.data(),
+                                      halfWidth);
+    
+    cout << "  Smoothed signal, first and second derivatives complete" << endl;
+    return true;
+}
+
+/**
+ * Validate SG window/order and look up the coefficient table
+ * Invalid sizes fall back to 5; invalid orders are clamped
+ */
+const double* Filter::sgCoefficients(int& filterSize, int& polyOrder) {
+    if (filterSize < 3 || filterSize % 2 == 0) {
+        cerr << "Warning: SG filter size must be odd and at least 3. Using 5." << endl;
+        filterSize = 5;
+    }
+    if (polyOrder < 0 || polyOrder > SavitzkyGolay::maxPolyOrder || polyOrder >= filterSize) {
+        int clamped = max(0, min(polyOrder, min(SavitzkyGolay::maxPolyOrder, filterSize - 1)));
+        cerr << "Warning: SG polynomial order " << polyOrder << " is not valid for size "
+             << filterSize << ". Using " << clamped << "." << endl;
+        polyOrder = clamped;
+    }
+    return SavitzkyGolay::coefficients(filterSize, polyOrder);
+}
+
+/**
+ * Single pass of Savitzky-Golay filter
+ * 
+ * Convolves with least-squares polynomial smoothing coefficients
+ * (Savitzky & Golay, Analytical Chemistry, 36, 1627 (1964)) using
+ * reflection boundaries. SG smoothing kernels are symmetric, so each
+ * pair of taps shares one multiply
+ */
+void Filter::sgPassInto(const double* in, double* out, size_t n,
+                        const double* coeffs, int halfWidth) {
+    Convolution::symmetric(in, out, n, coeffs, halfWidth);
+}
+
+/**
+ * Apply sliding-window median filter multiple times
+ */
+vector<double> Filter::applyMedian(const vector<double>& data, int filterSize, int numPasses) {
+    cout << "Applying " << numPasses << "-pass median filter (size " 
+              << filterSize << ")..." << endl;
+    
+    if (filterSize < 1 || filterSize % 2 == 0) {
+        cerr << "Warning: Median filter size must be odd and positive. Using 3." << endl;
+        filterSize = 3;
+    }
+    
+    vector<double> result(data.size());
+    vector<double> scratch(data.size());
+    runPasses(data.data(), result.data(), data.size(), numPasses, scratch.data(),
+              [filterSize](const double* in, double* out, size_t count) {
+                  medianPassInto(in, out, count, filterSize);
+              });
+    
+    cout << "  " << numPasses << " passes complete" << endl;
+    
+    return result;
+}
+
+/**
+ * Single pass of median filter with reflection boundaries
+ * 
+ * The window is kept in an ordered multiset (balanced tree) with an
+ * iterator on the median. Moving one sample adds the entering value and
+ * removes the leaving one, each O(log k), and the median iterator moves
+ * by at most one position, so a pass costs O(n log k).
+ */
+void Filter::medianPassInto(const double* in, double* out, size_t n, int filterSize) {
+    if (n == 0) {
+        return;
+    }
     
-    // Calculate half-width of filter window
     int halfWidth = (filterSize - 1) / 2;
+    int count = static_cast<int>(n);
     
-    // Apply boxcar filter to each point
-    for (size_t i = 0; i < n; i++) {
-        double sum = 0.0;
+    // Window around point 0
+    multiset<double> window;
+    for (int j = -halfWidth; j <= halfWidth; j++) {
+        window.insert(in[Convolution::reflectIndex(j, count)]);
+    }
+    multiset<double>::iterator median = next(window.begin(), halfWidth);
+    out[0] = *median;
+    
+    for (int i = 1; i < count; i++) {
+        double entering = in[Convolution::reflectIndex(i + halfWidth, count)];
+        double leaving = in[Convolution::reflectIndex(i - halfWidth - 1, count)];
         
-        // Sum over filter window with reflection boundaries
-        for (int j = -halfWidth; j <= halfWidth; j++) {
-            // Calculate index with reflection at boundaries
-            int idx = static_cast<int>(i) + j;
-            
-            // Handle negative indices (mirror at start)
-            if (idx < 0) {
-                idx = -idx;
-            }
-            // Handle indices past end (mirror at end)
-            if (idx >= static_cast<int>(n)) {
-                idx = 2 * static_cast<int>(n) - idx - 2;
-            }
-            // Safety bounds (for double reflection)
-            if (idx < 0) {
-                idx = 0;
-            }
-            if (idx >= static_cast<int>(n)) {
-                idx = n - 1;
-            }
-            
-            sum += data[idx];
+        // Equal values insert after existing ones, so only smaller values shift the median
+        window.insert(entering);
+        if (entering < *median) {
+            --median;
         }
         
-        // Calculate average
-        result[i] = sum / filterSize;
+        // Removing a value at or below the median shifts it up
+        if (leaving <= *median) {
+            ++median;
+        }
+        window.erase(window.lower_bound(leaving));
+        
+        out[i] = *median;
+    }
+}
+
+/**
+ * Apply Whittaker smoother multiple times
+ * The banded factor is cached per (n, lambda), so every pass after the
+ * first (and every later spectrum of the same length) costs only the
+ * triangular solves
+ */
+vector<double> Filter::applyWhittaker(const vector<double>& data, double lambda, int numPasses) {
+    cout << "Applying " << numPasses << "-pass Whittaker smoother (lambda " 
+              << lambda << ")..." << endl;
+    
+    if (!Whittaker::isValid(lambda)) {
+        cerr << "Warning: Whittaker lambda must be finite and non-negative. Using 100." << endl;
+        lambda = 100.0;
     }
     
+    vector<double> result(data.size());
+    vector<double> scratch(data.size());
+    runPasses(data.data(), result.data(), data.size(), numPasses, scratch.data(),
+              [lambda](const double* in, double* out, size_t count) {
+                  Whittaker::smooth(in, out, count, lambda);
+              });
+    
+    cout << "  " << numPasses << " passes complete" << endl;
+    
     return result;
 }
 
 /**
- * Apply Savitzky-Golay filter multiple times
+ * Apply stationary wavelet denoising multiple times
  */
-vector<double> Filter::applySavitzkyGolay(const vector<double>& data, 
-                                              int filterSize, int numPasses) {
-    cout << "Applying " << numPasses << "-pass Savitzky-Golay filter (size " 
-              << filterSize << ")..." << endl;
+vector<double> Filter::applyWavelet(const vector<double>& data, int family, int levels,
+                                    int numPasses) {
+    cout << "Applying " << numPasses << "-pass " << Wavelet::familyName(family)
+              << " wavelet denoising (" << levels << " levels)..." << endl;
     
-    vector<double> result = data;
-    for (int pass = 0; pass < numPasses; pass++) {
-        result = sgPass(result, filterSize);
-        cout << "  Pass " << (pass + 1) << " complete" << endl;
+    if (family != Wavelet::Haar && family != Wavelet::Daubechies4) {
+        cerr << "Warning: Unknown wavelet family " << family << ". Using Daubechies-4." << endl;
+        family = Wavelet::Daubechies4;
+    }
+    if (levels < 1 || levels > Wavelet::maxLevels) {
+        int clamped = max(1, min(levels, Wavelet::maxLevels));
+        cerr << "Warning: Wavelet levels must be 1-" << Wavelet::maxLevels << ". Using "
+             << clamped << "." << endl;
+        levels = clamped;
     }
     
+    vector<double> result(data.size());
+    vector<double> scratch(data.size());
+    runPasses(data.data(), result.data(), data.size(), numPasses, scratch.data(),
+              [family, levels](const double* in, double* out, size_t count) {
+                  Wavelet::denoise(in, out, count, family, levels);
+              });
+    
+    cout << "  " << numPasses << " passes complete" << endl;
+    
     return result;
 }
 
 /**
- * Single pass of Savitzky-Golay filter
+ * Filter comparison: shared first pass, then per-variant passes
  * 
- * Uses quadratic polynomial fitting with pre-computed convolution coefficients
- * Coefficients from: Savitzky & Golay, Analytical Chemistry, 36, 1627 (1964)
+ * For point i the window grows one pair (x[i-j], x[i+j]) at a time up to
+ * the widest size. The boxcar sum of size 2j+1 is read off as soon as the
+ * window reaches it, and each SG accumulator takes the pair while j is
+ * inside its window. SG columns follow Convolution's operation order, so
+ * they equal applySavitzkyGolay; boxcar columns are direct sums and can
+ * differ from the running-sum filter in the last bit.
  */
-vector<double> Filter::sgPass(const vector<double>& data, int filterSize) {
-    if (filterSize != 5 && filterSize != 11 && filterSize != 17) {
-        cerr << "Warning: SG filter size should be 5, 11, or 17. Using 5." << endl;
-        filterSize = 5;
+vector<vector<double>> Filter::compareFilters(const vector<double>& data,
+                                              const vector<int>& sizes, int numPasses,
+                                              int polyOrder, int numThreads,
+                                              vector<string>& names) {
+    cout << "Comparing filters (" << numPasses << " passes) in one traversal..." << endl;
+    
+    vector<int> boxSizes;
+    for (int size : sizes) {
+        if (size < 1 || size % 2 == 0) {
+            cerr << "Warning: Skipping comparison filter size " << size
+                 << " (must be odd and positive)" << endl;
+        } else {
+            boxSizes.push_back(size);
+        }
     }
+    sort(boxSizes.begin(), boxSizes.end());
+    boxSizes.erase(unique(boxSizes.begin(), boxSizes.end()), boxSizes.end());
     
-    if (data.empty()) {
-        return data;
+    vector<int> sgSizes;
+    vector<const double*> sgCoeffs;
+    for (int size : boxSizes) {
+        if (size >= 3) {
+            int order = polyOrder;
+            sgCoeffs.push_back(sgCoefficients(size, order));
+            sgSizes.push_back(size);
+        }
     }
     
     size_t n = data.size();
-    vector<double> result(n);
-    
-    // Savitzky-Golay convolution coefficients for quadratic polynomial
-    vector<double> coeffs;
-    double norm;
-    
-    if (filterSize == 5) {
-        // 5-point quadratic smoothing coefficients
-        coeffs = {-3.0, 12.0, 17.0, 12.0, -3.0};
-        norm = 35.0;
-    } else if (filterSize == 11) {
-        // 11-point quadratic smoothing coefficients
-        coeffs = {-36.0, 9.0, 44.0, 69.0, 84.0, 89.0, 84.0, 69.0, 44.0, 9.0, -36.0};
-        norm = 429.0;
-    } else { // filterSize == 17
-        // 17-point quadratic smoothing coefficients
-        coeffs = {-21.0, -6.0, 7.0, 18.0, 27.0, 34.0, 39.0, 42.0, 43.0, 
-                  42.0, 39.0, 34.0, 27.0, 18.0, 7.0, -6.0, -21.0};
-        norm = 323.0;
+    size_t numBox = boxSizes.size();
+    size_t numSG = sgSizes.size();
+    
+    names.clear();
+    names.push_back("none");
+    for (int size : boxSizes) {
+        names.push_back("boxcar" + to_string(size));
+    }
+    for (int size : sgSizes) {
+        names.push_back("sg" + to_string(size));
     }
     
-    int halfWidth = (filterSize - 1) / 2;
+    vector<vector<double>> columns(1 + numBox + numSG, vector<double>(n));
+    columns[0] = data;
+    if (numPasses <= 0 || n == 0) {
+        for (size_t v = 1; v < columns.size(); v++) {
+            columns[v] = data;
+        }
+        return columns;
+    }
+    
+    int maxHalf = boxSizes.empty() ? 0 : (boxSizes.back() - 1) / 2;
+    int count = static_cast<int>(n);
+    
+    // SG columns whose window reaches half width j are a suffix of sgSizes
+    vector<size_t> firstSG(maxHalf + 1, numSG);
+    for (int j = maxHalf; j >= 0; j--) {
+        for (size_t v = 0; v < numSG; v++) {
+            if ((sgSizes[v] - 1) / 2 >= j) {
+                firstSG[j] = v;
+                break;
+            }
+        }
+    }
     
-    // Apply SG filter to each point with reflection boundaries
+    // One sweep: every loaded pair feeds all filters that use it
+    const double* x = data.data();
+    vector<double> sgSum(numSG);
     for (size_t i = 0; i < n; i++) {
-        double sum = 0.0;
+        bool interior = i >= static_cast<size_t>(maxHalf) &&
+                        i + static_cast<size_t>(maxHalf) < n;
+        int center = static_cast<int>(i);
+        double boxSum = x[i];
+        size_t nextBox = 0;
+        for (size_t v = 0; v < numSG; v++) {
+            sgSum[v] = sgCoeffs[v][(sgSizes[v] - 1) / 2] * x[i];
+        }
         
-        // Convolve with coefficients
-        for (int j = -halfWidth; j <= halfWidth; j++) {
-            // Calculate index with reflection at boundaries
-            int idx = static_cast<int>(i) + j;
-            
-            // Handle negative indices (mirror at start)
-            if (idx < 0) {
-                idx = -idx;
-            }
-            // Handle indices past end (mirror at end)
-            if (idx >= static_cast<int>(n)) {
-                idx = 2 * static_cast<int>(n) - idx - 2;
+        for (int j = 0; j <= maxHalf; j++) {
+            if (j > 0) {
+                double pair = interior
+                    ? x[i - j] + x[i + j]
+                    : x[Convolution::reflectIndex(center - j, count)] +
+                      x[Convolution::reflectIndex(center + j, count)];
+                boxSum += pair;
+                for (size_t v = firstSG[j]; v < numSG; v++) {
+                    sgSum[v] += sgCoeffs[v][(sgSizes[v] - 1) / 2 + j] * pair;
+                }
             }
-            // Safety bounds (for double reflection)
-            if (idx < 0) {
-                idx = 0;
+            while (nextBox < numBox && (boxSizes[nextBox] - 1) / 2 == j) {
+                columns[1 + nextBox][i] = boxSum / boxSizes[nextBox];
+                nextBox++;
             }
-            if (idx >= static_cast<int>(n)) {
-                idx = n - 1;
-            }
-            
-            // Apply convolution coefficient
-            int coeffIdx = j + halfWidth;
-            sum += coeffs[coeffIdx] * data[idx];
         }
         
-        // Normalize
-        result[i] = sum / norm;
+        for (size_t v = 0; v < numSG; v++) {
+            columns[1 + numBox + v][i] = sgSum[v];
+        }
+    }
+    
+    // Remaining passes per variant (each works on its own column)
+    if (numPasses > 1) {
+        Parallel::forEach(numBox + numSG, numThreads, [&](size_t v) {
+            vector<double>& column = columns[1 + v];
+            vector<double> scratch(n);
+            if (v < numBox) {
+                applyBoxcar(column.data(), column.data(), n, boxSizes[v], numPasses - 1,
+                            scratch.data());
+            } else {
+                applySavitzkyGolay(column.data(), column.data(), n, sgSizes[v - numBox],
+                                   numPasses - 1, scratch.data(), polyOrder);
+            }
+        });
+    }
+    
+    cout << "  " << (columns.size() - 1) << " filter variants complete" << endl;
+    
+    return columns;
+}
+
+/**
+ * Apply boxcar filter in single precision
+ */
+vector<float> Filter::applyBoxcarFloat(const vector<float>& data, int filterSize, int numPasses) {
+    cout << "Applying " << numPasses << "-pass boxcar filter (size " 
+              << filterSize << ", float32)..." << endl;
+    
+    if (filterSize <= 0) {
+        numPasses = 0;
+    }
+    vector<float> result = runPassesFloat(data, numPasses,
+                                          [filterSize](const float* in, float* out, size_t count) {
+                                              boxcarPassFloat(in, out, count, filterSize);
+                                          });
+    
+    cout << "  " << numPasses << " passes complete" << endl;
+    
+    return result;
+}
+
+/**
+ * Apply Savitzky-Golay filter in single precision
+ */
+vector<float> Filter::applySavitzkyGolayFloat(const vector<float>& data, int filterSize,
+                                              int numPasses, int polyOrder) {
+    cout << "Applying " << numPasses << "-pass Savitzky-Golay filter (size " 
+              << filterSize << ", order " << polyOrder << ", float32)..." << endl;
+    
+    const double* coeffs = sgCoefficients(filterSize, polyOrder);
+    int halfWidth = (filterSize - 1) / 2;
+    vector<float> result = runPassesFloat(data, numPasses,
+                                          [coeffs, halfWidth](const float* in, float* out,
+                                                              size_t count) {
+                                              sgPassFloat(in, out, count, coeffs, halfWidth);
+                                          });
+    
+    cout << "  " << numPasses << " passes complete" << endl;
+    
+    return result;
+}
+
+/**
+ * Run float passes, alternating between result and one scratch buffer
+ */
+vector<float> Filter::runPassesFloat(const vector<float>& data, int numPasses,
+                                     const FloatPassKernel& kernel) {
+    vector<float> result = data;
+    if (numPasses <= 0 || data.empty()) {
+        return result;
     }
     
+    vector<float> scratch(data.size());
+    for (int pass = 0; pass < numPasses; pass++) {
+        kernel(result.data(), scratch.data(), data.size());
+        result.swap(scratch);
+    }
     return result;
-}
\ No newline at end of file
+}
+
+/**
+ * Single boxcar pass over float samples
+ * Same regions and re-seeding as boxcarPassRange; a double sum of float
+ * samples is exact to well below float resolution, so no compensation
+ * term is needed
+ */
+void Filter::boxcarPassFloat(const float* in, float* out, size_t n, int filterSize) {
+    int halfWidth = (filterSize - 1) / 2;
+    size_t k = static_cast<size_t>(halfWidth);
+    int count = static_cast<int>(n);
+    
+    // Windows wider than the data need repeated reflection - use direct sums
+    if (n < 2 * k + 2) {
+        for (size_t i = 0; i < n; i++) {
+            double sum = 0.0;
+            for (int j = -halfWidth; j <= halfWidth; j++) {
+                sum += in[Convolution::reflectIndex(static_cast<int>(i) + j, count)];
+            }
+            out[i] = static_cast<float>(sum / filterSize);
+        }
+        return;
+    }
+    
+    for (size_t blockStart = 0; blockStart < n; blockStart += boxcarReseedInterval) {
+        size_t blockEnd = min(n, blockStart + boxcarReseedInterval);
+        
+        double sum = 0.0;
+        for (int j = -halfWidth; j <= halfWidth; j++) {
+            sum += in[Convolution::reflectIndex(static_cast<int>(blockStart) + j, count)];
+        }
+        out[blockStart] = static_cast<float>(sum / filterSize);
+        
+        size_t i = blockStart + 1;
+        for (size_t stop = min(blockEnd, k + 1); i < stop; i++) {
+            sum += static_cast<double>(in[i + k]) - in[k + 1 - i];
+            out[i] = static_cast<float>(sum / filterSize);
+        }
+        for (size_t stop = min(blockEnd, n - k); i < stop; i++) {
+            sum += static_cast<double>(in[i + k]) - in[i - k - 1];
+            out[i] = static_cast<float>(sum / filterSize);
+        }
+        for (; i < blockEnd; i++) {
+            sum += static_cast<double>(in[2 * n - 2 - i - k]) - in[i - k - 1];
+            out[i] = static_cast<float>(sum / filterSize);
+        }
+    }
+}
+
+/**
+ * Single SG pass over float samples
+ */
+void Filter::sgPassFloat(const float* in, float* out, size_t n,
+                         const double* coeffs, int halfWidth) {
+    Convolution::symmetric(in, out, n, coeffs, halfWidth);
+}
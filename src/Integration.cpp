@@ -1,14 +1,131 @@
 #include "Integration.h"
+#include "GaussLegendre.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 using namespace std;
 
+namespace {
+
+/**
+ * Apply the N-point rule to the spline on [a, b]
+ */
+template <int N>
+double gaussLegendreSum(const CubicSpline& spline, double a, double b) {
+    static constexpr GaussLegendreRule<N> rule{};
+    
+    // Transform from [-1, 1] to [a, b]
+    double midpoint = (a + b) / 2.0;
+    double halfwidth = (b - a) / 2.0;
+    
+    double sum = 0.0;
+    
+    // Use symmetry: integrate from -1 to 1 using both positive and negative nodes
+    for (int i = 0; i < N / 2; i++) {
+        double x_pos = midpoint + halfwidth * rule.nodes[i];
+        double x_neg = midpoint - halfwidth * rule.nodes[i];
+        
+        sum += rule.weights[i] * (spline.evaluate(x_pos) + spline.evaluate(x_neg));
+    }
+    
+    return halfwidth * sum;
+}
+
+/**
+ * Apply the N-point rule to every interval [a[p], b[p]]
+ * 
+ * Node layout per interval is ascending (negative half reversed, then
+ * positive half) so sorted, non-overlapping intervals give one ascending
+ * array for the spline's forward scan. The reduction uses the same pairing
+ * and order as gaussLegendreSum, so results are bit-identical.
+ */
+template <int N>
+vector<double> gaussLegendreBatchSum(const CubicSpline& spline,
+                                     const vector<double>& a,
+                                     const vector<double>& b) {
+    static constexpr GaussLegendreRule<N> rule{};
+    const int half = N / 2;
+    size_t numIntervals = a.size();
+    
+    // Gather all nodes into one contiguous array
+    vector<double> xs(numIntervals * N);
+    for (size_t p = 0; p < numIntervals; p++) {
+        double midpoint = (a[p] + b[p]) / 2.0;
+        double halfwidth = (b[p] - a[p]) / 2.0;
+        double* xp = &xs[p * N];
+        
+        for (int i = 0; i < half; i++) {
+            xp[half - 1 - i] = midpoint - halfwidth * rule.nodes[i];
+            xp[half + i] = midpoint + halfwidth * rule.nodes[i];
+        }
+    }
+    
+    // Single bulk spline pass
+    vector<double> fs;
+    spline.evaluate(xs, fs);
+    
+    // Reduce per interval
+    vector<double> result(numIntervals);
+    for (size_t p = 0; p < numIntervals; p++) {
+        double halfwidth = (b[p] - a[p]) / 2.0;
+        const double* fp = &fs[p * N];
+        
+        double sum = 0.0;
+        for (int i = 0; i < half; i++) {
+            sum += rule.weights[i] * (fp[half + i] + fp[half - 1 - i]);
+        }
+        result[p] = halfwidth * sum;
+    }
+    
+    return result;
+}
+
+/**
+ * Fill stats for an N-point rule by comparing against the N/2-point rule
+ */
+template <int N>
+double gaussLegendreWithStats(const CubicSpline& spline, double a, double b,
+                              IntegrationStats* stats) {
+    double integral = gaussLegendreSum<N>(spline, a, b);
+    if (stats) {
+        double coarse = gaussLegendreSum<N / 2>(spline, a, b);
+        stats->evaluations = N + N / 2;
+        stats->levels = 1;
+        stats->errorEstimate = fabs(integral - coarse);
+    }
+    return integral;
+}
+
+/**
+ * Batched version of gaussLegendreWithStats
+ */
+template <int N>
+vector<double> gaussLegendreBatchWithStats(const CubicSpline& spline,
+                                           const vector<double>& a,
+                                           const vector<double>& b,
+                                           vector<IntegrationStats>* stats) {
+    vector<double> result = gaussLegendreBatchSum<N>(spline, a, b);
+    if (stats) {
+        vector<double> coarse = gaussLegendreBatchSum<N / 2>(spline, a, b);
+        stats->assign(result.size(), IntegrationStats());
+        for (size_t p = 0; p < result.size(); p++) {
+            (*stats)[p].evaluations = N + N / 2;
+            (*stats)[p].levels = 1;
+            (*stats)[p].errorEstimate = fabs(result[p] - coarse[p]);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
 /**
  * Newton-Cotes integration (composite Simpson's rule)
  * Uses adaptive subdivision until tolerance is met
  */
-double Integration::newtonCotes(const CubicSpline& spline, double a, double b, double tolerance) {
+double Integration::newtonCotes(const CubicSpline& spline, double a, double b, double tolerance,
+                                IntegrationStats* stats) {
     if (!spline.isComputed()) {
         cerr << "Error: Spline not computed" << endl;
         return 0.0;
@@ -20,6 +137,7 @@ double Integration::newtonCotes(const CubicSpline& spline, double a, double b, d
     double integral = 0.0;
     
     const int maxIterations = 20;
+    IntegrationStats local;
     
     for (int iter = 0; iter < maxIterations; iter++) {
         // Composite Simpson's rule: I = (h/3)[f(x0) + 4f(x1) + 2f(x2) + 4f(x3) + ... + f(xn)]
@@ -37,16 +155,26 @@ double Integration::newtonCotes(const CubicSpline& spline, double a, double b, d
         }
         
         integral = (h / 3.0) * sum;
+        local.evaluations += n + 1;
+        local.levels = iter + 1;
         
         // Check convergence
-        if (iter > 0 && abs(integral - prevIntegral) < tolerance) {
-            return integral;
+        if (iter > 0) {
+            local.errorEstimate = abs(integral - prevIntegral);
+            if (local.errorEstimate < tolerance) {
+                local.converged = true;
+                break;
+            }
         }
         
         prevIntegral = integral;
         n *= 2;  // Double the number of intervals
     }
     
+    if (stats) {
+        *stats = local;
+    }
+    
     // Return best estimate even if not fully converged
     return integral;
 }
@@ -55,7 +183,8 @@ double Integration::newtonCotes(const CubicSpline& spline, double a, double b, d
  * Romberg integration
  * Uses Richardson extrapolation on trapezoidal rule
  */
-double Integration::romberg(const CubicSpline& spline, double a, double b, double tolerance) {
+double Integration::romberg(const CubicSpline& spline, double a, double b, double tolerance,
+                            IntegrationStats* stats) {
     if (!spline.isComputed()) {
         cerr << "Error: Spline not computed" << endl;
         return 0.0;
@@ -63,11 +192,15 @@ double Integration::romberg(const CubicSpline& spline, double a, double b, doubl
     
     const int maxLevel = 15;  // Maximum Romberg levels
     double R[maxLevel][maxLevel];
+    IntegrationStats local;
+    double result = 0.0;
     
     // First column: trapezoidal rule with increasing subdivisions
     for (int i = 0; i < maxLevel; i++) {
         int n = static_cast<int>(pow(2, i));
         R[i][0] = trapezoid(spline, a, b, n);
+        local.evaluations += n + 1;
+        local.levels = i + 1;
         
         // Richardson extrapolation for higher order approximations
         for (int j = 1; j <= i; j++) {
@@ -75,21 +208,32 @@ double Integration::romberg(const CubicSpline& spline, double a, double b, doubl
             R[i][j] = (factor * R[i][j-1] - R[i-1][j-1]) / (factor - 1.0);
         }
         
+        result = R[i][i];
+        
         // Check convergence (compare diagonal elements)
-        if (i > 0 && abs(R[i][i] - R[i-1][i-1]) < tolerance) {
-            return R[i][i];
+        if (i > 0) {
+            local.errorEstimate = abs(R[i][i] - R[i-1][i-1]);
+            if (local.errorEstimate < tolerance) {
+                local.converged = true;
+                break;
+            }
         }
     }
     
+    if (stats) {
+        *stats = local;
+    }
+    
     // Return best estimate
-    return R[maxLevel-1][maxLevel-1];
+    return result;
 }
 
 /**
  * Adaptive quadrature
  * Uses recursive Simpson's rule with automatic subdivision
  */
-double Integration::adaptive(const CubicSpline& spline, double a, double b, double tolerance) {
+double Integration::adaptive(const CubicSpline& spline, double a, double b, double tolerance,
+                             IntegrationStats* stats) {
     if (!spline.isComputed()) {
         cerr << "Error: Spline not computed" << endl;
         return 0.0;
@@ -100,109 +244,142 @@ double Integration::adaptive(const CubicSpline& spline, double a, double b, doub
     double fb = spline.evaluate(b);
     double fmid = spline.evaluate((a + b) / 2.0);
     
-    return adaptiveHelper(spline, a, b, tolerance, fa, fb, fmid);
+    IntegrationStats local;
+    local.evaluations = 3;
+    local.converged = true;
+    
+    double integral = adaptiveHelper(spline, a, b, tolerance, fa, fb, fmid, 1, local);
+    
+    if (stats) {
+        *stats = local;
+    }
+    
+    return integral;
 }
 
 /**
- * Gauss-Legendre quadrature (64 points)
+ * Gauss-Legendre quadrature (8, 16, 32, 64 or 128 points)
+ * Error estimate compares against the rule with half as many points;
+ * a fixed-order rule has no tolerance, so converged is left to the caller
  */
-double Integration::gaussLegendre(const CubicSpline& spline, double a, double b) {
+double Integration::gaussLegendre(const CubicSpline& spline, double a, double b, int order,
+                                  IntegrationStats* stats) {
     if (!spline.isComputed()) {
         cerr << "Error: Spline not computed" << endl;
         return 0.0;
     }
     
-    // 64-point Gauss-Legendre abscissas and weights
-    // These are for the standard interval [-1, 1]
-    // Only store positive values; use symmetry for negative
-    const int n = 32;  // We'll use symmetry, so only need half
-    
-    // Nodes and weights for 64-point Gauss-Legendre quadrature (first 32)
-    static const double nodes[32] = {
-        0.0243502926634244325089558,
-        0.0729931217877990394495429,
-        0.1214628192961205544703765,
-        0.1696444204239928180373136,
-        0.2174236437400070841496487,
-        0.2646871622087674163739642,
-        0.3113228719902109561575127,
-        0.3572201583376681159504426,
-        0.4022701579639916036957668,
-        0.4463660172534640879849477,
-        0.4894031457070529574785263,
-        0.5312794640198945456580139,
-        0.5718956462026340342838781,
-        0.6111553551723932502488530,
-        0.6489654712546573398577612,
-        0.6852363130542332425635584,
-        0.7198818501716108268489402,
-        0.7528199072605318966118638,
-        0.7839723589433414076102205,
-        0.8132653151227975597419233,
-        0.8406292962525803627516915,
-        0.8659993981540928197607834,
-        0.8893154459951141058534040,
-        0.9105221370785028057563807,
-        0.9295691721319395758214902,
-        0.9464113748584028160624815,
-        0.9610087996520537189186141,
-        0.9733268277899109637418535,
-        0.9833362538846259569312993,
-        0.9910133714767443207393824,
-        0.9963401167719552793469245,
-        0.9993050417357721394569056
-    };
-    
-    static const double weights[32] = {
-        0.0486909570091397203833654,
-        0.0485754674415034269347991,
-        0.0483447622348029571697695,
-        0.0479993885964583077281262,
-        0.0475401657148303086622822,
-        0.0469681828162100173253263,
-        0.0462847965813144172959532,
-        0.0454916279274181444797710,
-        0.0445905581637565630601347,
-        0.0435837245293234533768279,
-        0.0424735151236535890073398,
-        0.0412625632426235286101563,
-        0.0399537411327203413866569,
-        0.0385501531786156291289625,
-        0.0370551285402400460404151,
-        0.0354722132568823838106931,
-        0.0338051618371416093915655,
-        0.0320579283548515535854675,
-        0.0302346570724024788679741,
-        0.0283396726142594832275113,
-        0.0263774697150546586716918,
-        0.0243527025687108733381776,
-        0.0222701738083832541592983,
-        0.0201348231535302093723403,
-        0.0179517157756973430850453,
-        0.0157260304760247193219660,
-        0.0134630478967186425980608,
-        0.0111681394601311288185905,
-        0.0088467598263639477230309,
-        0.0065044579689783628561174,
-        0.0041470332605624676352875,
-        0.0017832807216964329472961
-    };
+    switch (order) {
+        case 8:   return gaussLegendreWithStats<8>(spline, a, b, stats);
+        case 16:  return gaussLegendreWithStats<16>(spline, a, b, stats);
+        case 32:  return gaussLegendreWithStats<32>(spline, a, b, stats);
+        case 64:  return gaussLegendreWithStats<64>(spline, a, b, stats);
+        case 128: return gaussLegendreWithStats<128>(spline, a, b, stats);
+        default:
+            cerr << "Warning: Unsupported Gauss-Legendre order " << order
+                 << ". Using 64." << endl;
+            return gaussLegendreWithStats<64>(spline, a, b, stats);
+    }
+}
+
+/**
+ * Batched Gauss-Legendre quadrature over many intervals
+ */
+vector<double> Integration::gaussLegendreBatch(const CubicSpline& spline,
+                                               const vector<double>& a,
+                                               const vector<double>& b,
+                                               int order,
+                                               vector<IntegrationStats>* stats) {
+    if (!spline.isComputed()) {
+        cerr << "Error: Spline not computed" << endl;
+        return vector<double>(a.size(), 0.0);
+    }
     
-    // Transform from [-1, 1] to [a, b]
-    double midpoint = (a + b) / 2.0;
-    double halfwidth = (b - a) / 2.0;
+    if (a.size() != b.size()) {
+        cerr << "Error: Interval bound sizes don't match" << endl;
+        return vector<double>(a.size(), 0.0);
+    }
     
-    double sum = 0.0;
+    switch (order) {
+        case 8:   return gaussLegendreBatchWithStats<8>(spline, a, b, stats);
+        case 16:  return gaussLegendreBatchWithStats<16>(spline, a, b, stats);
+        case 32:  return gaussLegendreBatchWithStats<32>(spline, a, b, stats);
+        case 64:  return gaussLegendreBatchWithStats<64>(spline, a, b, stats);
+        case 128: return gaussLegendreBatchWithStats<128>(spline, a, b, stats);
+        default:
+            cerr << "Warning: Unsupported Gauss-Legendre order " << order
+                 << ". Using 64." << endl;
+            return gaussLegendreBatchWithStats<64>(spline, a, b, stats);
+    }
+}
+
+/**
+ * Cost-model driven method choice
+ */
+int Integration::chooseMethod(const CubicSpline& spline, double a, double b, double tolerance,
+                              int& gaussOrder, double& estimatedCost) {
+    // Error constants fitted to the bundled spectra (upper envelope)
+    const double gaussErrorConstant = 5e-3;
+    const double simpsonErrorConstant = 1e-2;
+    const double adaptiveEvalsPerLevel = 1.2;
     
-    // Use symmetry: integrate from -1 to 1 using both positive and negative nodes
-    for (int i = 0; i < n; i++) {
-        double x_pos = midpoint + halfwidth * nodes[i];
-        double x_neg = midpoint - halfwidth * nodes[i];
-        
-        sum += weights[i] * (spline.evaluate(x_pos) + spline.evaluate(x_neg));
+    double width = fabs(b - a);
+    double pieces = static_cast<double>(spline.segmentCount(a, b));
+    double jumps = spline.thirdDerivativeJumps(a, b);
+    
+    // Newton-Cotes: first n whose previous level already met tolerance
+    int n = 2;
+    double ncCost = 3.0;
+    while (n < (1 << 20) &&
+           simpsonErrorConstant * jumps * pow(2.0 * width / n, 4) >= tolerance) {
+        n *= 2;
+        ncCost += n + 1;
+    }
+    if (n == 2) {
+        // Needs a second level to confirm convergence
+        ncCost += 5.0;
     }
     
-    return halfwidth * sum;
+    // Adaptive: each piece is refined until h^3 J < tol / w
+    double adaptiveCost = 3.0;
+    if (jumps > 0.0 && width > 0.0) {
+        double h = cbrt(tolerance / (simpsonErrorConstant * width * jumps));
+        double depth = max(1.0, log2(width / h));
+        adaptiveCost += adaptiveEvalsPerLevel * pieces * depth;
+    } else {
+        adaptiveCost += 2.0;
+    }
+    
+    // Gauss-Legendre: smallest tabulated order predicted to meet tolerance
+    int bestType = 2;
+    estimatedCost = adaptiveCost;
+    gaussOrder = 64;
+    
+    if (ncCost < estimatedCost) {
+        bestType = 0;
+        estimatedCost = ncCost;
+    }
+    
+    for (int order = 8; order <= 128; order *= 2) {
+        double error = gaussErrorConstant * jumps * pow(width / order, 4);
+        if (error < tolerance) {
+            if (order < estimatedCost) {
+                bestType = 3;
+                gaussOrder = order;
+                estimatedCost = order;
+            }
+            break;
+        }
+    }
+    
+    return bestType;
+}
+
+/**
+ * Check whether a Gauss-Legendre rule of the given order is available
+ */
+bool Integration::isSupportedGaussOrder(int order) {
+    return order == 8 || order == 16 || order == 32 || order == 64 || order == 128;
 }
 
 /**
@@ -224,7 +401,8 @@ double Integration::trapezoid(const CubicSpline& spline, double a, double b, int
  * Recursively subdivides intervals until tolerance is met
  */
 double Integration::adaptiveHelper(const CubicSpline& spline, double a, double b,
-                                  double tolerance, double fa, double fb, double fmid) {
+                                  double tolerance, double fa, double fb, double fmid,
+                                  int depth, IntegrationStats& stats) {
     double mid = (a + b) / 2.0;
     double h = b - a;
     
@@ -239,6 +417,11 @@ double Integration::adaptiveHelper(const CubicSpline& spline, double a, double b
     // Simpson's rule on right half [mid, b]
     double rightMid = (mid + b) / 2.0;
     double f_rightMid = spline.evaluate(rightMid);
+    stats.evaluations += 2;
+    if (depth > stats.levels) {
+        stats.levels = depth;
+    }
+    
     double S_right = (h / 12.0) * (fmid + 4.0 * f_rightMid + fb);
     
     double S_split = S_left + S_right;
@@ -248,14 +431,15 @@ double Integration::adaptiveHelper(const CubicSpline& spline, double a, double b
     
     // If error is acceptable, return refined estimate
     if (error < tolerance) {
+        stats.errorEstimate += error;
         return S_split + (S_split - S_whole) / 15.0;  // Richardson correction
     }
     
     // Otherwise, recursively subdivide with tighter tolerance
     double left_integral = adaptiveHelper(spline, a, mid, tolerance / 2.0, 
-                                         fa, fmid, f_leftMid);
+                                         fa, fmid, f_leftMid, depth + 1, stats);
     double right_integral = adaptiveHelper(spline, mid, b, tolerance / 2.0, 
-                                          fmid, fb, f_rightMid);
+                                          fmid, fb, f_rightMid, depth + 1, stats);
     
     return left_integral + right_integral;
 }
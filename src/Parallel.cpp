@@ -0,0 +1,53 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Resolve requested thread count (0 = hardware concurrency)
+ */
+int Parallel::resolveThreads(int requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    
+    unsigned int hw = thread::hardware_concurrency();
+    return hw > 0 ? static_cast<int>(hw) : 1;
+}
+
+/**
+ * Run body(i) for i in [0, count) on up to numThreads threads
+ * The calling thread takes part, so numThreads = 1 runs inline
+ */
+void Parallel::forEach(size_t count, int numThreads,
+                       const function<void(size_t)>& body) {
+    size_t workers = min(static_cast<size_t>(resolveThreads(numThreads)), count);
+    
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            body(i);
+        }
+        return;
+    }
+    
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            body(i);
+        }
+    };
+    
+    vector<thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t t = 1; t < workers; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    
+    for (auto& th : threads) {
+        th.join();
+    }
+}
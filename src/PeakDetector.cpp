@@ -1,5 +1,7 @@
 #include "PeakDetector.h"
 #include "Integration.h"
+#include "Parallel.h"
+#include "CumulativeIntegral.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -132,30 +134,137 @@ vector<Peak> PeakDetector::detectPeaks(const CubicSpline& spline,
 void PeakDetector::integratePeaks(vector<Peak>& peaks,
                                  const CubicSpline& spline,
                                  int integrationType,
-                                 double tolerance) {
+                                 double tolerance,
+                                 int gaussOrder,
+                                 int numThreads,
+                                 bool collectStats) {
     cout << "Integrating peaks..." << endl;
     
-    for (size_t i = 0; i < peaks.size(); i++) {
+    if (integrationType < 0 || integrationType == 4 || integrationType == 5 ||
+        integrationType > 6) {
+        cerr << "Unknown integration type: " << integrationType << endl;
+        for (auto& peak : peaks) {
+            peak.area = 0.0;
+            peak.stats = IntegrationStats();
+            peak.method = "";
+        }
+        return;
+    }
+    
+    // Gauss-Legendre uses fixed nodes, so all peaks go through one batch
+    if (integrationType == 3) {
+        vector<double> begins(peaks.size());
+        vector<double> ends(peaks.size());
+        for (size_t i = 0; i < peaks.size(); i++) {
+            begins[i] = peaks[i].begin;
+            ends[i] = peaks[i].end;
+        }
+        
+        // The error estimate costs a second (half-order) rule, so only
+        // compute it when the report asks for it
+        vector<IntegrationStats> stats;
+        vector<double> areas = Integration::gaussLegendreBatch(spline, begins, ends, gaussOrder,
+                                                               collectStats ? &stats : nullptr);
+        for (size_t i = 0; i < peaks.size(); i++) {
+            peaks[i].area = areas[i];
+            peaks[i].stats = collectStats ? stats[i] : IntegrationStats();
+            peaks[i].stats.converged = collectStats && stats[i].errorEstimate <= tolerance;
+            peaks[i].method = "GL-" + to_string(gaussOrder);
+        }
+        return;
+    }
+    
+    // Peaks are independent and each writes only its own area,
+    // so the result is identical for any thread count
+    Parallel::forEach(peaks.size(), numThreads, [&](size_t i) {
         Peak& peak = peaks[i];
         
+        // Automatic: pick per peak from the cost model
+        int method = integrationType;
+        int order = gaussOrder;
+        if (integrationType == 6) {
+            double estimatedCost = 0.0;
+            method = Integration::chooseMethod(spline, peak.begin, peak.end, tolerance,
+                                               order, estimatedCost);
+        }
+        
         // Integrate based on method
-        switch (integrationType) {
+        peak.stats = IntegrationStats();
+        IntegrationStats* stats = collectStats ? &peak.stats : nullptr;
+        switch (method) {
             case 0:
-                peak.area = Integration::newtonCotes(spline, peak.begin, peak.end, tolerance);
+                peak.area = Integration::newtonCotes(spline, peak.begin, peak.end, tolerance,
+                                                     stats);
+                peak.method = "Newton-Cotes";
                 break;
             case 1:
-                peak.area = Integration::romberg(spline, peak.begin, peak.end, tolerance);
+                peak.area = Integration::romberg(spline, peak.begin, peak.end, tolerance, stats);
+                peak.method = "Romberg";
                 break;
             case 2:
-                peak.area = Integration::adaptive(spline, peak.begin, peak.end, tolerance);
+                peak.area = Integration::adaptive(spline, peak.begin, peak.end, tolerance, stats);
+                peak.method = "Adaptive";
                 break;
             case 3:
-                peak.area = Integration::gaussLegendre(spline, peak.begin, peak.end);
+                peak.area = Integration::gaussLegendre(spline, peak.begin, peak.end, order,
+                                                       stats);
+                peak.stats.converged = collectStats && peak.stats.errorEstimate <= tolerance;
+                peak.method = "GL-" + to_string(order);
                 break;
             default:
-                cerr << "Unknown integration type: " << integrationType << endl;
                 peak.area = 0.0;
         }
+    });
+    
+    if (integrationType == 6) {
+        for (size_t i = 0; i < peaks.size(); i++) {
+            cout << "  Peak " << (i + 1) << ": " << peaks[i].method;
+            if (collectStats) {
+                cout << " (" << peaks[i].stats.evaluations << " evaluations)";
+            }
+            cout << endl;
+        }
+    }
+}
+
+/**
+ * Integrate all peaks from the data samples using cumulative sums
+ */
+void PeakDetector::integratePeaksRaw(vector<Peak>& peaks,
+                                     const CubicSpline& spline,
+                                     const vector<double>& xData,
+                                     const vector<double>& yData,
+                                     bool useSimpson,
+                                     double tolerance) {
+    cout << "Integrating peaks from data samples (cumulative "
+         << (useSimpson ? "Simpson" : "trapezoid") << ")..." << endl;
+    
+    CumulativeIntegral cumulative;
+    if (!cumulative.compute(xData, yData, useSimpson)) {
+        for (auto& peak : peaks) {
+            peak.area = 0.0;
+            peak.stats = IntegrationStats();
+            peak.method = "";
+        }
+        return;
+    }
+    
+    for (size_t i = 0; i < peaks.size(); i++) {
+        Peak& peak = peaks[i];
+        peak.area = cumulative.integrate(peak.begin, peak.end);
+        
+        // Compare against the exact spline area
+        double splineArea = spline.integrate(peak.begin, peak.end);
+        double difference = peak.area - splineArea;
+        
+        peak.stats = IntegrationStats();
+        peak.method = useSimpson ? "Simpson-data" : "Trapezoid-data";
+        peak.stats.errorEstimate = fabs(difference);
+        peak.stats.converged = peak.stats.errorEstimate <= tolerance;
+        
+        cout << "  Peak " << (i + 1) << ": data area " << peak.area
+             << ", spline area " << splineArea
+             << ", difference " << difference << endl;
     }
 }
 
@@ -186,7 +295,7 @@ void PeakDetector::calculateHydrogens(vector<Peak>& peaks) {
 /**
  * Print peaks in formatted table to output stream
  */
-void PeakDetector::printPeaks(ostream& os, const vector<Peak>& peaks) {
+void PeakDetector::printPeaks(ostream& os, const vector<Peak>& peaks, bool showStats) {
     os << "\n";
     os << setw(7) << "Peak" << " "
               << setw(16) << "Begin" << " "
@@ -194,7 +303,15 @@ void PeakDetector::printPeaks(ostream& os, const vector<Peak>& peaks) {
               << setw(16) << "Location" << " "
               << setw(16) << "Top" << " "
               << setw(16) << "Area" << " "
-              << setw(9) << "Hydrogens" << endl;
+              << setw(9) << "Hydrogens";
+    if (showStats) {
+        os << " " << setw(16) << "Method" << " "
+                  << setw(9) << "Evals" << " "
+                  << setw(6) << "Levels" << " "
+                  << setw(9) << "Converged" << " "
+                  << setw(16) << "Error Estimate";
+    }
+    os << endl;
     
     os << string(7, '=') << " "
               << string(16, '=') << " "
@@ -202,7 +319,15 @@ void PeakDetector::printPeaks(ostream& os, const vector<Peak>& peaks) {
               << string(16, '=') << " "
               << string(16, '=') << " "
               << string(16, '=') << " "
-              << string(9, '=') << endl;
+              << string(9, '=');
+    if (showStats) {
+        os << " " << string(16, '=') << " "
+                  << string(9, '=') << " "
+                  << string(6, '=') << " "
+                  << string(9, '=') << " "
+                  << string(16, '=');
+    }
+    os << endl;
     
     for (size_t i = 0; i < peaks.size(); i++) {
         const Peak& peak = peaks[i];
@@ -212,7 +337,15 @@ void PeakDetector::printPeaks(ostream& os, const vector<Peak>& peaks) {
                   << setw(16) << fixed << setprecision(12) << peak.location << " "
                   << setw(16) << fixed << setprecision(6) << peak.maximum << " "
                   << setw(16) << scientific << setprecision(10) << peak.area << " "
-                  << setw(9) << peak.hydrogens << endl;
+                  << setw(9) << peak.hydrogens;
+        if (showStats) {
+            os << " " << setw(16) << peak.method << " "
+                      << setw(9) << peak.stats.evaluations << " "
+                      << setw(6) << peak.stats.levels << " "
+                      << setw(9) << (peak.stats.converged ? "yes" : "no") << " "
+                      << setw(16) << scientific << setprecision(6) << peak.stats.errorEstimate;
+        }
+        os << endl;
     }
     
     os << endl;
@@ -221,6 +354,6 @@ void PeakDetector::printPeaks(ostream& os, const vector<Peak>& peaks) {
 /**
  * Print peaks in formatted table to cout
  */
-void PeakDetector::printPeaks(const vector<Peak>& peaks) {
-    printPeaks(cout, peaks);
+void PeakDetector::printPeaks(const vector<Peak>& peaks, bool showStats) {
+    printPeaks(cout, peaks, showStats);
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "SavitzkyGolay.h"
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * Generalized factorial a(a-1)...(a-b+1)
+ */
+constexpr long double genFactorial(int a, int b) {
+    long double result = 1.0L;
+    for (int j = a - b + 1; j <= a; j++) {
+        result *= j;
+    }
+    return result;
+}
+
+/**
+ * Gram polynomials and their derivatives over the points -m..m
+ * p[s][k] is the s-th derivative of P_k at t, for s <= derivative, k <= order:
+ * P_k^s(t) = 2(2k-1)/(k(2m-k+1)) (t P_{k-1}^s(t) + s P_{k-1}^{s-1}(t))
+ *          - (k-1)(2m+k)/(k(2m-k+1)) P_{k-2}^s(t)
+ */
+constexpr void gramPolynomials(int m, int order, int derivative, int t,
+                               long double (*p)[SavitzkyGolay::maxPolyOrder + 1]) {
+    for (int s = 0; s <= derivative; s++) {
+        p[s][0] = (s == 0) ? 1.0L : 0.0L;
+        for (int k = 1; k <= order; k++) {
+            long double denom = static_cast<long double>(k) * (2 * m - k + 1);
+            long double lower = (s > 0) ? p[s - 1][k - 1] : 0.0L;
+            long double previous = (k >= 2) ? p[s][k - 2] : 0.0L;
+            p[s][k] = (2.0L * (2 * k - 1) * (t * p[s][k - 1] + s * lower)
+                       - static_cast<long double>(k - 1) * (2 * m + k) * previous) / denom;
+        }
+    }
+}
+
+/**
+ * Fill coeffs[0..2m] with weights for the derivative-th derivative at the
+ * window centre (per unit sample spacing):
+ * h(i) = sum_k (2k+1) (2m)^(k) / (2m+k+1)^(k+1) P_k(i) P_k^s(0)
+ * Evaluated in long double so the rounded weights are (nearly) exact
+ */
+constexpr void generateCoefficients(int m, int order, int derivative, double* coeffs) {
+    long double centre[SavitzkyGolay::maxDerivative + 1][SavitzkyGolay::maxPolyOrder + 1] = {};
+    long double point[SavitzkyGolay::maxDerivative + 1][SavitzkyGolay::maxPolyOrder + 1] = {};
+    gramPolynomials(m, order, derivative, 0, centre);
+
+    for (int i = -m; i <= m; i++) {
+        gramPolynomials(m, order, 0, i, point);
+        long double sum = 0.0L;
+        for (int k = 0; k <= order; k++) {
+            sum += (2 * k + 1) * genFactorial(2 * m, k) / genFactorial(2 * m + k + 1, k + 1)
+                 * point[0][k] * centre[derivative][k];
+        }
+        coeffs[i + m] = static_cast<double>(sum);
+    }
+}
+
+/**
+ * Compile-time coefficient table for one (window, order) pair
+ */
+template<int N, int Order>
+struct SGTable {
+    static_assert(N % 2 == 1 && Order < N, "Window must be odd and wider than the order");
+
+    double coeffs[N];
+
+    constexpr SGTable() : coeffs() {
+        generateCoefficients((N - 1) / 2, Order, 0, coeffs);
+    }
+};
+
+template<int N, int Order>
+const double* table() {
+    static constexpr SGTable<N, Order> t{};
+    return t.coeffs;
+}
+
+/**
+ * Look up a compile-time table (nullptr if the pair is not tabulated)
+ */
+const double* tabulated(int windowSize, int polyOrder) {
+    if (polyOrder == 2) {
+        switch (windowSize) {
+            case 5:  return table<5, 2>();
+            case 7:  return table<7, 2>();
+            case 9:  return table<9, 2>();
+            case 11: return table<11, 2>();
+            case 17: return table<17, 2>();
+            case 25: return table<25, 2>();
+        }
+    } else if (polyOrder == 4) {
+        switch (windowSize) {
+            case 5:  return table<5, 4>();
+            case 7:  return table<7, 4>();
+            case 9:  return table<9, 4>();
+            case 11: return table<11, 4>();
+            case 17: return table<17, 4>();
+            case 25: return table<25, 4>();
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+/**
+ * Check window size and polynomial order
+ */
+bool SavitzkyGolay::isValid(int windowSize, int polyOrder) {
+    return windowSize >= 3 && windowSize % 2 == 1 &&
+           polyOrder >= 0 && polyOrder <= maxPolyOrder && polyOrder < windowSize;
+}
+
+/**
+ * Get coefficients from the compile-time tables or the runtime cache
+ */
+const double* SavitzkyGolay::coefficients(int windowSize, int polyOrder, int derivative) {
+    if (!isValid(windowSize, polyOrder) || derivative < 0 || derivative > maxDerivative) {
+        return nullptr;
+    }
+
+    if (derivative == 0) {
+        const double* coeffs = tabulated(windowSize, polyOrder);
+        if (coeffs != nullptr) {
+            return coeffs;
+        }
+    }
+
+    // Map nodes never move, so returned pointers stay valid after later inserts
+    static map<tuple<int, int, int>, vector<double>> cache;
+    static mutex cacheMutex;
+
+    lock_guard<mutex> lock(cacheMutex);
+    vector<double>& entry = cache[make_tuple(windowSize, polyOrder, derivative)];
+    if (entry.empty()) {
+        entry.resize(windowSize);
+        generateCoefficients((windowSize - 1) / 2, polyOrder, derivative, entry.data());
+    }
+    return entry.data();
+}
@@ -0,0 +1,246 @@
+#include "SpectrumFile.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SPECTRUMFILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char spectrumMagic[8] = {'N', 'M', 'R', 'S', 'P', 'E', 'C', '\0'};
+const uint32_t byteOrderTag = 0x01020304;
+const uint32_t uniformGridFlag = 1;
+const size_t headerBytes = 64;
+const size_t dataAlignment = 64;
+
+// Fixed 64-byte header at the start of the file
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t count;
+    double x0;
+    double dx;
+    uint64_t metadataBytes;
+    uint64_t dataOffset;
+    uint32_t byteOrder;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == headerBytes, "Spectrum header must be 64 bytes");
+
+}
+
+/**
+ * Constructor
+ */
+SpectrumFile::SpectrumFile()
+    : base(nullptr), mappedBytes(0), mapped(false), count(0), uniform(false),
+      x0(0.0), dx(0.0), xValues(nullptr), yValues(nullptr) {
+}
+
+SpectrumFile::~SpectrumFile() {
+    close();
+}
+
+/**
+ * Map the file and check that the header and columns fit
+ */
+bool SpectrumFile::open(const string& filename) {
+    close();
+
+#ifdef SPECTRUMFILE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Error: Cannot open spectrum file: " << filename << endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < headerBytes) {
+        ::close(fd);
+        cerr << "Error: Spectrum file is too short: " << filename << endl;
+        return false;
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        cerr << "Error: Cannot map spectrum file: " << filename << endl;
+        return false;
+    }
+    base = static_cast<const char*>(mapping);
+    mappedBytes = fileSize;
+    mapped = true;
+#else
+    ifstream inFile(filename, ios::binary | ios::ate);
+    if (!inFile.is_open()) {
+        cerr << "Error: Cannot open spectrum file: " << filename << endl;
+        return false;
+    }
+    size_t fileSize = static_cast<size_t>(inFile.tellg());
+    inFile.seekg(0);
+    buffer.resize(fileSize);
+    inFile.read(buffer.data(), fileSize);
+    if (fileSize < headerBytes || !inFile) {
+        buffer.clear();
+        cerr << "Error: Spectrum file is too short: " << filename << endl;
+        return false;
+    }
+    base = buffer.data();
+    mappedBytes = fileSize;
+#endif
+
+    Header header;
+    memcpy(&header, base, headerBytes);
+
+    string problem;
+    if (memcmp(header.magic, spectrumMagic, sizeof(spectrumMagic)) != 0) {
+        problem = "not a spectrum file";
+    } else if (header.byteOrder != byteOrderTag) {
+        problem = "written with a different byte order";
+    } else if (header.version != formatVersion) {
+        problem = "unsupported format version " + to_string(header.version);
+    } else if (header.dataOffset > mappedBytes ||
+               header.metadataBytes > mappedBytes - headerBytes ||
+               header.dataOffset % dataAlignment != 0 ||
+               header.dataOffset < headerBytes + header.metadataBytes) {
+        problem = "truncated or inconsistent header";
+    } else {
+        // Compare counts rather than byte totals so nothing can overflow
+        size_t columns = (header.flags & uniformGridFlag) ? 1 : 2;
+        if (header.count > (mappedBytes - header.dataOffset) / (columns * sizeof(double))) {
+            problem = "truncated or inconsistent header";
+        }
+    }
+    if (!problem.empty()) {
+        cerr << "Error: " << filename << ": " << problem << endl;
+        close();
+        return false;
+    }
+
+    count = header.count;
+    uniform = (header.flags & uniformGridFlag) != 0;
+    x0 = header.x0;
+    dx = header.dx;
+    meta.assign(base + headerBytes, header.metadataBytes);
+
+    // Data starts on a 64-byte boundary of a page-aligned mapping
+    const double* columns = reinterpret_cast<const double*>(base + header.dataOffset);
+    xValues = uniform ? nullptr : columns;
+    yValues = uniform ? columns : columns + count;
+
+    return true;
+}
+
+/**
+ * Release the mapping
+ */
+void SpectrumFile::close() {
+#ifdef SPECTRUMFILE_MMAP
+    if (mapped && base != nullptr) {
+        munmap(const_cast<char*>(base), mappedBytes);
+    }
+#endif
+    buffer.clear();
+    base = nullptr;
+    mappedBytes = 0;
+    mapped = false;
+    count = 0;
+    uniform = false;
+    xValues = nullptr;
+    yValues = nullptr;
+    meta.clear();
+}
+
+/**
+ * x value of point i
+ */
+double SpectrumFile::x(size_t i) const {
+    return uniform ? x0 + dx * static_cast<double>(i) : xValues[i];
+}
+
+/**
+ * Check the magic bytes
+ */
+bool SpectrumFile::isSpectrumFile(const string& filename) {
+    ifstream inFile(filename, ios::binary);
+    char magic[sizeof(spectrumMagic)];
+    if (!inFile.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return memcmp(magic, spectrumMagic, sizeof(spectrumMagic)) == 0;
+}
+
+/**
+ * Write header, metadata and columns
+ */
+bool SpectrumFile::write(const string& filename, const vector<double>& xData,
+                         const vector<double>& yData, const string& metadata,
+                         double gridTolerance) {
+    if (xData.size() != yData.size()) {
+        cerr << "Error: x and y sizes don't match" << endl;
+        return false;
+    }
+
+    size_t n = xData.size();
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, spectrumMagic, sizeof(spectrumMagic));
+    header.version = formatVersion;
+    header.count = n;
+    header.metadataBytes = metadata.size();
+    header.dataOffset = (headerBytes + metadata.size() + dataAlignment - 1) /
+                        dataAlignment * dataAlignment;
+    header.byteOrder = byteOrderTag;
+
+    // Uniform grid through the end points, if every x is close enough to it
+    if (n >= 2) {
+        double start = xData.front();
+        double step = (xData.back() - xData.front()) / static_cast<double>(n - 1);
+        double limit = max(gridTolerance, 1e-12 * max(fabs(start), fabs(xData.back())));
+        bool fits = step != 0.0;
+        for (size_t i = 0; i < n && fits; i++) {
+            fits = fabs(start + step * static_cast<double>(i) - xData[i]) <= limit;
+        }
+        if (fits) {
+            header.flags |= uniformGridFlag;
+            header.x0 = start;
+            header.dx = step;
+        }
+    }
+
+    ofstream outFile(filename, ios::binary);
+    if (!outFile.is_open()) {
+        cerr << "Error: Cannot open output file: " << filename << endl;
+        return false;
+    }
+
+    vector<char> padding(header.dataOffset - headerBytes - metadata.size(), '\0');
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outFile.write(metadata.data(), metadata.size());
+    outFile.write(padding.data(), padding.size());
+    if (!(header.flags & uniformGridFlag)) {
+        outFile.write(reinterpret_cast<const char*>(xData.data()), n * sizeof(double));
+    }
+    outFile.write(reinterpret_cast<const char*>(yData.data()), n * sizeof(double));
+
+    if (!outFile) {
+        cerr << "Error: Failed writing spectrum file: " << filename << endl;
+        return false;
+    }
+
+    cout << "Spectrum written to: " << filename << " (" << n << " points, "
+              << ((header.flags & uniformGridFlag) ? "uniform grid" : "explicit x column")
+              << ")" << endl;
+    return true;
+}
@@ -0,0 +1,354 @@
+#include "StreamingFilter.h"
+#include "Filter.h"
+#include "Convolution.h"
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+using namespace std;
+
+/**
+ * One pass of the streaming pipeline
+ *
+ * Consumes the previous stage's output a chunk at a time, keeping a ring
+ * buffer of the chunk plus the last few windows of samples. Output i is
+ * emitted once input i + k has arrived (or at the end of the stream),
+ * so only the left boundary is reflected until the length is known.
+ * Nothing is emitted before 2k + 2 samples have arrived, so a stream
+ * shorter than that takes the same direct-sum path as the batch filter.
+ * Each filter repeats the batch pass's arithmetic in the same order:
+ * - boxcar: running sums with the same re-seeding points as boxcarPassInto
+ * - Savitzky-Golay: c[m] x[i] + sum_j c[m+j] (x[i-j] + x[i+j])
+ * - median: ordered window with the same insert/erase sequence
+ */
+class StreamingFilter::Stage {
+public:
+    Stage(int filterType, int filterSize, const double* coeffs, size_t maxInput)
+        : filterType(filterType), filterSize(filterSize), k((filterSize - 1) / 2),
+          coeffs(coeffs), received(0), nextOut(0), total(0), ended(false),
+          sum(0.0), comp(0.0) {
+        // Unemitted backlog (at most 2k + 1) plus k + 1 samples of history
+        size_t ringSize = 1;
+        while (ringSize < maxInput + 3 * k + 2) {
+            ringSize *= 2;
+        }
+        ring.assign(ringSize, 0.0);
+        mask = ringSize - 1;
+    }
+
+    // Push count input samples (last = end of stream); writes every output
+    // that became ready to out and returns how many were written
+    size_t push(const double* in, size_t count, bool last, double* out) {
+        for (size_t j = 0; j < count; j++) {
+            ring[(received + j) & mask] = in[j];
+        }
+        received += count;
+        if (last) {
+            total = received;
+            ended = true;
+        }
+
+        size_t ready = ended ? total : (received >= 2 * k + 2 ? received - k : 0);
+        size_t first = nextOut;
+        if (ready > nextOut) {
+            if (filterType == 1) {
+                emitBoxcar(ready, out);
+            } else if (filterType == 2) {
+                emitConvolution(ready, out);
+            } else {
+                emitMedian(ready, out);
+            }
+        }
+        return nextOut - first;
+    }
+
+    // Whether skipAhead(offset) keeps every ring slot, re-seed point and
+    // boundary region: offset is a multiple of the ring size and re-seed
+    // interval, and the left boundary has been emitted
+    bool canSkip(size_t offset) const {
+        return !ended && nextOut > k && offset % ring.size() == 0 &&
+               offset % Filter::boxcarReseedInterval == 0;
+    }
+
+    // Renumber positions as if offset more samples had passed
+    void skipAhead(size_t offset) {
+        received += offset;
+        nextOut += offset;
+    }
+
+private:
+    int filterType;
+    int filterSize;
+    size_t k;
+    const double* coeffs;
+    vector<double> ring;
+    size_t mask;
+    size_t received;
+    size_t nextOut;
+    size_t total;
+    bool ended;
+    double sum;  // boxcar running sum
+    double comp;
+    multiset<double> window;  // median window
+    multiset<double>::iterator median;
+
+    // Ring slot of a (possibly reflected) stream index. Mirrors like
+    // Convolution::reflectIndex, but in ptrdiff_t so that positions past
+    // 2^31 do not wrap; before the end every index read is below received
+    size_t slot(ptrdiff_t idx) const {
+        ptrdiff_t n = static_cast<ptrdiff_t>(ended ? total : received);
+        if (idx < 0) {
+            idx = -idx;
+        }
+        if (idx >= n) {
+            idx = 2 * n - idx - 2;
+        }
+        if (idx < 0) {
+            idx = 0;
+        }
+        if (idx >= n) {
+            idx = n - 1;
+        }
+        return static_cast<size_t>(idx) & mask;
+    }
+
+    // Boxcar outputs nextOut..hi-1, split into the same regions as boxcarPassRange
+    void emitBoxcar(size_t hi, double* out) {
+        // Work on locals so stores to out cannot force reloads of members
+        const double* buf = ring.data();
+        size_t m = mask;
+        double s = sum;
+        double c = comp;
+        size_t i = nextOut;
+        ptrdiff_t halfWidth = static_cast<ptrdiff_t>(k);
+
+        // Windows wider than the data need repeated reflection - use direct sums
+        if (ended && total < 2 * k + 2) {
+            for (; i < hi; i++) {
+                double direct = 0.0;
+                for (ptrdiff_t j = -halfWidth; j <= halfWidth; j++) {
+                    direct += buf[slot(static_cast<ptrdiff_t>(i) + j)];
+                }
+                *out++ = direct / filterSize;
+            }
+            nextOut = hi;
+            return;
+        }
+
+        // Before the end no output reaches the right boundary
+        size_t interiorEnd = ended ? total - k : hi;
+
+        while (i < hi) {
+            if (i % Filter::boxcarReseedInterval == 0) {
+                s = 0.0;
+                c = 0.0;
+                for (ptrdiff_t j = -halfWidth; j <= halfWidth; j++) {
+                    Filter::neumaierAdd(s, c, buf[slot(static_cast<ptrdiff_t>(i) + j)]);
+                }
+                *out++ = (s + c) / filterSize;
+                i++;
+                continue;
+            }
+
+            size_t blockEnd = min(hi, (i / Filter::boxcarReseedInterval + 1) *
+                                      Filter::boxcarReseedInterval);
+
+            // Left edge: leaving sample is reflected
+            for (size_t end = min(blockEnd, k + 1); i < end; i++) {
+                Filter::neumaierAdd(s, c, buf[(i + k) & m]);
+                Filter::neumaierAdd(s, c, -buf[(k + 1 - i) & m]);
+                *out++ = (s + c) / filterSize;
+            }
+
+            // Interior: no reflection
+            for (size_t end = min(blockEnd, interiorEnd); i < end; i++) {
+                Filter::neumaierAdd(s, c, buf[(i + k) & m]);
+                Filter::neumaierAdd(s, c, -buf[(i - k - 1) & m]);
+                *out++ = (s + c) / filterSize;
+            }
+
+            // Right edge: entering sample is reflected
+            for (; i < blockEnd; i++) {
+                Filter::neumaierAdd(s, c, buf[(2 * total - 2 - i - k) & m]);
+                Filter::neumaierAdd(s, c, -buf[(i - k - 1) & m]);
+                *out++ = (s + c) / filterSize;
+            }
+        }
+
+        sum = s;
+        comp = c;
+        nextOut = hi;
+    }
+
+    // Savitzky-Golay outputs nextOut..hi-1 (same order as Convolution::symmetric)
+    void emitConvolution(size_t hi, double* out) {
+        const double* buf = ring.data();
+        size_t m = mask;
+        ptrdiff_t halfWidth = static_cast<ptrdiff_t>(k);
+
+        for (size_t i = nextOut; i < hi; i++) {
+            ptrdiff_t center = static_cast<ptrdiff_t>(i);
+            double s = coeffs[halfWidth] * buf[i & m];
+            if (i >= k && (!ended || i + k < total)) {
+                for (ptrdiff_t j = 1; j <= halfWidth; j++) {
+                    double pair = buf[(i - j) & m] + buf[(i + j) & m];
+                    s += coeffs[halfWidth + j] * pair;
+                }
+            } else {
+                for (ptrdiff_t j = 1; j <= halfWidth; j++) {
+                    double pair = buf[slot(center - j)] + buf[slot(center + j)];
+                    s += coeffs[halfWidth + j] * pair;
+                }
+            }
+            *out++ = s;
+        }
+        nextOut = hi;
+    }
+
+    // Median outputs nextOut..hi-1 (same window updates as medianPassInto)
+    void emitMedian(size_t hi, double* out) {
+        const double* buf = ring.data();
+        ptrdiff_t halfWidth = static_cast<ptrdiff_t>(k);
+        size_t i = nextOut;
+
+        if (i == 0) {
+            for (ptrdiff_t j = -halfWidth; j <= halfWidth; j++) {
+                window.insert(buf[slot(j)]);
+            }
+            median = std::next(window.begin(), halfWidth);
+            *out++ = *median;
+            i++;
+        }
+
+        for (; i < hi; i++) {
+            ptrdiff_t center = static_cast<ptrdiff_t>(i);
+            double entering = buf[slot(center + halfWidth)];
+            double leaving = buf[slot(center - halfWidth - 1)];
+
+            window.insert(entering);
+            if (entering < *median) {
+                --median;
+            }
+            if (leaving <= *median) {
+                ++median;
+            }
+            window.erase(window.lower_bound(leaving));
+
+            *out++ = *median;
+        }
+        nextOut = hi;
+    }
+};
+
+/**
+ * Constructor - validate the settings and build one stage per pass
+ */
+StreamingFilter::StreamingFilter(int filterType, int filterSize, int numPasses, int polyOrder)
+    : received(0), emitted(0), finished(false) {
+    const double* coeffs = nullptr;
+    if (filterType == 1) {
+        if (filterSize <= 0) {
+            numPasses = 0;
+        }
+    } else if (filterType == 2) {
+        coeffs = Filter::sgCoefficients(filterSize, polyOrder);
+    } else if (filterType == 3) {
+        if (filterSize < 1 || filterSize % 2 == 0) {
+            cerr << "Warning: Median filter size must be odd and positive. Using 3." << endl;
+            filterSize = 3;
+        }
+    } else {
+        numPasses = 0;
+    }
+
+    // Each stage can release up to 2k + 2 more samples than it was given
+    int halfWidth = max(0, (filterSize - 1) / 2);
+    size_t maxChunk = chunkSize + static_cast<size_t>(max(numPasses, 0)) * (2 * halfWidth + 2);
+
+    for (int pass = 0; pass < numPasses; pass++) {
+        stages.emplace_back(new Stage(filterType, filterSize, coeffs, maxChunk));
+    }
+    if (!stages.empty()) {
+        pending.resize(maxChunk);
+        next.resize(maxChunk);
+    }
+}
+
+StreamingFilter::~StreamingFilter() {
+}
+
+/**
+ * Push samples through the pipeline a chunk at a time
+ */
+void StreamingFilter::push(const double* data, size_t count, vector<double>& filtered) {
+    if (finished) {
+        cerr << "Error: Cannot push samples after the stream has finished" << endl;
+        return;
+    }
+
+    for (size_t start = 0; start < count; start += chunkSize) {
+        size_t length = min(chunkSize, count - start);
+        runStages(data + start, length, false, filtered);
+    }
+    received += count;
+}
+
+void StreamingFilter::push(const vector<double>& chunk, vector<double>& filtered) {
+    push(chunk.data(), chunk.size(), filtered);
+}
+
+/**
+ * Flush every stage, reflecting at the now-known right boundary
+ */
+void StreamingFilter::finish(vector<double>& filtered) {
+    if (finished) {
+        return;
+    }
+    runStages(nullptr, 0, true, filtered);
+    finished = true;
+}
+
+/**
+ * Renumber the stream as if offset more samples had already passed
+ */
+bool StreamingFilter::skipAhead(size_t offset) {
+    if (finished) {
+        return false;
+    }
+    for (const unique_ptr<Stage>& stage : stages) {
+        if (!stage->canSkip(offset)) {
+            return false;
+        }
+    }
+    for (const unique_ptr<Stage>& stage : stages) {
+        stage->skipAhead(offset);
+    }
+    received += offset;
+    emitted += offset;
+    return true;
+}
+
+/**
+ * Feed one chunk through all stages, appending the last stage's output
+ */
+void StreamingFilter::runStages(const double* data, size_t count, bool last,
+                                vector<double>& filtered) {
+    if (stages.empty()) {
+        if (count > 0) {
+            filtered.insert(filtered.end(), data, data + count);
+        }
+        emitted += count;
+        return;
+    }
+
+    const double* in = data;
+    for (size_t pass = 0; pass < stages.size(); pass++) {
+        count = stages[pass]->push(in, count, last, next.data());
+        pending.swap(next);
+        in = pending.data();
+    }
+
+    filtered.insert(filtered.end(), in, in + count);
+    emitted += count;
+}
@@ -0,0 +1,202 @@
+#include "Wavelet.h"
+#include "Convolution.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Daubechies-4 lifting constants (Daubechies & Sweldens, J. Fourier Anal.
+// Appl., 4, 247 (1998))
+const double sqrt3 = 1.7320508075688772;
+const double updateNear = sqrt3 / 4.0;
+const double updateFar = (sqrt3 - 2.0) / 4.0;
+const double scaleApprox = (sqrt3 + 1.0) / 1.4142135623730951;
+const double scaleDetail = (sqrt3 - 1.0) / 1.4142135623730951;
+
+/**
+ * Index inside [0, n), reflecting only when it falls outside
+ */
+inline size_t mirror(long idx, size_t n) {
+    if (idx >= 0 && idx < static_cast<long>(n)) {
+        return static_cast<size_t>(idx);
+    }
+    return static_cast<size_t>(Convolution::reflectIndex(static_cast<int>(idx),
+                                                         static_cast<int>(n)));
+}
+
+}
+
+/**
+ * Denoise: forward transform, threshold every detail band, inverse transform
+ *
+ * The transform runs on the samples padded at both ends by point symmetry
+ * through the end sample (x[-j] = 2 x[0] - x[j]), which continues a straight
+ * line exactly. The pad covers everything the lifting steps can reach, so
+ * the reflection at the padded ends never touches the output, and linear
+ * trends are kept right up to the ends instead of being pulled by half a
+ * step per level. Noise estimates use the real samples only.
+ */
+bool Wavelet::denoise(const double* in, double* out, size_t n, int family, int levels,
+                      double thresholdScale) {
+    if ((family != Haar && family != Daubechies4) || levels < 1 || levels > maxLevels ||
+        !(thresholdScale >= 0.0)) {
+        return false;
+    }
+
+    if (n < 2) {
+        if (out != in) {
+            copy(in, in + n, out);
+        }
+        return true;
+    }
+
+    // Every dilated step must fit inside the data
+    while (levels > 1 && (static_cast<size_t>(1) << (levels - 1)) >= n) {
+        levels--;
+    }
+
+    // Each level reaches at most 5 steps each way going forward and 5 back
+    size_t pad = 10 * ((static_cast<size_t>(1) << levels) - 1);
+    size_t length = n + 2 * pad;
+
+    // One allocation for the padded approximation, all detail bands and the MAD scratch
+    vector<double> work(static_cast<size_t>(levels + 2) * length);
+    double* approx = work.data();
+    double* bands = approx + length;
+    double* scratch = bands + static_cast<size_t>(levels) * length;
+
+    // Fill outward by distance: each extended value mirrors one already set
+    copy(in, in + n, approx + pad);
+    size_t first = pad;
+    size_t last = pad + n - 1;
+    for (size_t j = 1; j <= pad; j++) {
+        approx[first - j] = 2.0 * approx[first] - approx[first + j];
+        approx[last + j] = 2.0 * approx[last] - approx[last - j];
+    }
+
+    for (int level = 0; level < levels; level++) {
+        forwardLevel(approx, bands + level * length, length, static_cast<size_t>(1) << level,
+                     family);
+    }
+
+    if (thresholdScale > 0.0) {
+        for (int level = 0; level < levels; level++) {
+            threshold(bands + level * length, n, pad, thresholdScale, scratch);
+        }
+    }
+
+    for (int level = levels - 1; level >= 0; level--) {
+        inverseLevel(approx, bands + level * length, length, static_cast<size_t>(1) << level,
+                     family);
+    }
+
+    copy(approx + pad, approx + pad + n, out);
+    return true;
+}
+
+/**
+ * Name of a wavelet family
+ */
+const char* Wavelet::familyName(int family) {
+    switch (family) {
+        case Haar: return "Haar";
+        case Daubechies4: return "Daubechies-4";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * One undecimated level of forward lifting
+ *
+ * The "even" samples are approx[i] and the "odd" samples approx[i + step];
+ * neighbouring coefficients of the decimated scheme sit 2 * step apart.
+ * Haar:  d = o - e, a = e + d / 2
+ * D4:    d = o - sqrt3 e, a = e + sqrt3/4 d + (sqrt3 - 2)/4 d[-1],
+ *        d = d + a[+1], then a and d are rescaled
+ */
+void Wavelet::forwardLevel(double* approx, double* detail, size_t n, size_t step, int family) {
+    long s = static_cast<long>(step);
+
+    for (size_t i = 0; i < n; i++) {
+        double odd = approx[mirror(static_cast<long>(i) + s, n)];
+        detail[i] = (family == Haar) ? odd - approx[i] : odd - sqrt3 * approx[i];
+    }
+
+    if (family == Haar) {
+        for (size_t i = 0; i < n; i++) {
+            approx[i] += 0.5 * detail[i];
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        approx[i] += updateNear * detail[i] +
+                     updateFar * detail[mirror(static_cast<long>(i) - 2 * s, n)];
+    }
+    for (size_t i = 0; i < n; i++) {
+        detail[i] += approx[mirror(static_cast<long>(i) + 2 * s, n)];
+    }
+    for (size_t i = 0; i < n; i++) {
+        approx[i] *= scaleApprox;
+        detail[i] *= scaleDetail;
+    }
+}
+
+/**
+ * One undecimated level of inverse lifting
+ *
+ * Undoing the lifting steps gives the even samples in approx and the odd
+ * samples (shifted by step) in detail. After thresholding the two no
+ * longer agree exactly, so each point is the average of both estimates
+ * (the even one alone in the first step points, which lie in the pad).
+ */
+void Wavelet::inverseLevel(double* approx, double* detail, size_t n, size_t step, int family) {
+    long s = static_cast<long>(step);
+
+    if (family == Haar) {
+        for (size_t i = 0; i < n; i++) {
+            approx[i] -= 0.5 * detail[i];
+            detail[i] += approx[i];
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            approx[i] /= scaleApprox;
+            detail[i] /= scaleDetail;
+        }
+        for (size_t i = 0; i < n; i++) {
+            detail[i] -= approx[mirror(static_cast<long>(i) + 2 * s, n)];
+        }
+        for (size_t i = 0; i < n; i++) {
+            approx[i] -= updateNear * detail[i] +
+                         updateFar * detail[mirror(static_cast<long>(i) - 2 * s, n)];
+        }
+        for (size_t i = 0; i < n; i++) {
+            detail[i] += sqrt3 * approx[i];
+        }
+    }
+
+    for (size_t i = step; i < n; i++) {
+        approx[i] = 0.5 * (approx[i] + detail[i - step]);
+    }
+}
+
+/**
+ * Soft thresholding at thresholdScale * sigma * sqrt(2 ln n),
+ * with sigma = median(|d|) / 0.6745 over the n real samples of this band
+ */
+void Wavelet::threshold(double* detail, size_t n, size_t pad, double scale, double* scratch) {
+    for (size_t i = 0; i < n; i++) {
+        scratch[i] = fabs(detail[pad + i]);
+    }
+    nth_element(scratch, scratch + n / 2, scratch + n);
+    double sigma = scratch[n / 2] / 0.6745;
+    double limit = scale * sigma * sqrt(2.0 * log(static_cast<double>(n)));
+
+    for (size_t i = 0; i < n + 2 * pad; i++) {
+        double magnitude = fabs(detail[i]) - limit;
+        detail[i] = (magnitude > 0.0) ? copysign(magnitude, detail[i]) : 0.0;
+    }
+}
@@ -0,0 +1,132 @@
+#include "Whittaker.h"
+#include <cmath>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Unit lower-triangular factor with two sub-diagonals and the diagonal D:
+ * A = L D L', L[i][i-1] = l1[i], L[i][i-2] = l2[i]
+ */
+struct Whittaker::Factor {
+    vector<double> d;
+    vector<double> l1;
+    vector<double> l2;
+};
+
+/**
+ * Check whether a smoothing parameter can be used
+ */
+bool Whittaker::isValid(double lambda) {
+    return isfinite(lambda) && lambda >= 0.0;
+}
+
+/**
+ * Build (or fetch) the factor of I + lambda D'D for n points
+ *
+ * With second differences, D'D is pentadiagonal with rows
+ *   [1 -2 1], [-2 5 -4 1], [1 -4 6 -4 1] ... mirrored at the far end,
+ * and each banded Cholesky step only touches the two previous rows.
+ */
+shared_ptr<const Whittaker::Factor> Whittaker::factor(size_t n, double lambda) {
+    static map<pair<size_t, double>, shared_ptr<const Factor>> cache;
+    static deque<pair<size_t, double>> order;
+    static mutex cacheMutex;
+
+    pair<size_t, double> key(n, lambda);
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        auto found = cache.find(key);
+        if (found != cache.end()) {
+            return found->second;
+        }
+    }
+
+    // Factor outside the lock; a concurrent build of the same key is harmless
+    shared_ptr<Factor> f = make_shared<Factor>();
+    f->d.resize(n);
+    f->l1.assign(n, 0.0);
+    f->l2.assign(n, 0.0);
+
+    for (size_t i = 0; i < n; i++) {
+        // Row i of D'D: one entry per second difference covering point i
+        double centre = (i >= 2 ? 1.0 : 0.0) + (i >= 1 && i + 1 < n ? 4.0 : 0.0) +
+                        (i + 2 < n ? 1.0 : 0.0);
+        double off1 = (i >= 1 && i + 1 < n ? 2.0 : 0.0) + (i >= 2 ? 2.0 : 0.0);
+        double a0 = 1.0 + lambda * centre;
+        double a1 = -lambda * off1;
+        double a2 = (i >= 2) ? lambda : 0.0;
+
+        double l2 = 0.0;
+        double l1 = 0.0;
+        double d = a0;
+        if (i >= 2) {
+            l2 = a2 / f->d[i - 2];
+            l1 = (a1 - l2 * f->d[i - 2] * f->l1[i - 1]) / f->d[i - 1];
+            d -= l1 * l1 * f->d[i - 1] + l2 * l2 * f->d[i - 2];
+        } else if (i == 1) {
+            l1 = a1 / f->d[0];
+            d -= l1 * l1 * f->d[0];
+        }
+
+        f->l1[i] = l1;
+        f->l2[i] = l2;
+        f->d[i] = d;
+    }
+
+    lock_guard<mutex> lock(cacheMutex);
+    auto inserted = cache.insert(make_pair(key, shared_ptr<const Factor>(f)));
+    if (inserted.second) {
+        order.push_back(key);
+        if (order.size() > maxCachedFactors) {
+            cache.erase(order.front());
+            order.pop_front();
+        }
+    }
+    return inserted.first->second;
+}
+
+/**
+ * Smooth with the cached factor: forward solve L w = y, scale by D,
+ * then back solve L' z = w
+ */
+bool Whittaker::smooth(const double* y, double* z, size_t n, double lambda) {
+    if (!isValid(lambda)) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+
+    shared_ptr<const Factor> f = factor(n, lambda);
+    const double* d = f->d.data();
+    const double* l1 = f->l1.data();
+    const double* l2 = f->l2.data();
+
+    // Forward substitution (z may alias y: each z[i] only needs y[i])
+    z[0] = y[0];
+    if (n > 1) {
+        z[1] = y[1] - l1[1] * z[0];
+    }
+    for (size_t i = 2; i < n; i++) {
+        z[i] = y[i] - l1[i] * z[i - 1] - l2[i] * z[i - 2];
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        z[i] /= d[i];
+    }
+
+    // Back substitution
+    if (n > 1) {
+        z[n - 2] -= l1[n - 1] * z[n - 1];
+        for (size_t i = n - 2; i-- > 0;) {
+            z[i] -= l1[i + 1] * z[i + 1] + l2[i + 2] * z[i + 2];
+        }
+    }
+
+    return true;
+}
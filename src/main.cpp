@@ -2,16 +2,41 @@
 #include <chrono>
 #include <fstream>
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include "Config.h"
 #include "DataReader.h"
 #include "Filter.h"
 #include "CubicSpline.h"
 #include "PeakDetector.h"
 #include "DataWriter.h"
+#include "SpectrumFile.h"
 
 using namespace std;
 using namespace chrono;
 
+/**
+ * Sample spacing for SG derivatives, which assume a uniform grid
+ * Every x must lie within 5% of a step of the grid through the end points
+ * (recorded spectra round x, so the bundled data is about 1.3% off)
+ * @param x - sample positions
+ * @param spacing - output: grid step
+ * @return true if x is uniform
+ */
+static bool uniformSpacing(const vector<double>& x, double& spacing) {
+    if (x.size() < 2) {
+        return false;
+    }
+    spacing = (x.back() - x.front()) / static_cast<double>(x.size() - 1);
+    double limit = 0.05 * fabs(spacing);
+    for (size_t i = 0; i < x.size(); i++) {
+        if (fabs(x.front() + spacing * static_cast<double>(i) - x[i]) > limit) {
+            return false;
+        }
+    }
+    return spacing != 0.0;
+}
+
 /**
  * Main program for NMR Spectrum Analysis
  * 
@@ -25,13 +50,37 @@ using namespace chrono;
  * 4. Applies smoothing filter (boxcar or Savitzky-Golay)
  * 5. Fits natural cubic spline to filtered data
  * 6. Detects peaks above baseline
- * 7. Integrates peak areas using specified method
+ * 7. Integrates peak areas using specified method (spline or raw data)
  * 8. Calculates relative hydrogen counts
  * 9. Outputs results to file
+ * 
+ * "nmr_analysis --convert in.dat out.nmrb [gridTolerance]" instead converts
+ * a two-column text file to the binary SpectrumFile format and exits.
  */
 int main(int argc, char* argv[]) {
     auto startTime = high_resolution_clock::now();
     
+    if (argc > 1 && string(argv[1]) == "--convert") {
+        if (argc < 4) {
+            cerr << "Usage: " << argv[0] << " --convert input.dat output.nmrb [gridTolerance]" << endl;
+            return 1;
+        }
+        double gridTolerance = (argc > 4) ? atof(argv[4]) : 0.0;
+        
+        DataReader source;
+        if (!source.readFromFile(argv[2], 0)) {
+            cerr << "Failed to read data file: " << argv[2] << endl;
+            return 1;
+        }
+        
+        string metadata = "format=NMRSPEC\nsource=" + string(argv[2]) +
+                          "\npoints=" + to_string(source.size()) +
+                          "\ngridTolerance=" + to_string(gridTolerance) +
+                          "\nconverter=nmr_analysis --convert\n";
+        return SpectrumFile::write(argv[3], source.xData, source.yData, metadata,
+                                   gridTolerance) ? 0 : 1;
+    }
+    
     // Determine config file name (default: nmr.in)
     string configFile = "nmr.in";
     if (argc > 1) {
@@ -54,7 +103,7 @@ int main(int argc, char* argv[]) {
     
     // Read NMR data
     DataReader data;
-    if (!data.readFromFile(config.inputFilename)) {
+    if (!data.readFromFile(config.inputFilename, config.numThreads)) {
         cerr << "Failed to read data file: " << config.inputFilename << endl;
         return 1;
     }
@@ -72,18 +121,134 @@ int main(int argc, char* argv[]) {
 
     cout << endl;
     
+    // Median pre-pass removes single-point spikes before smoothing
+    if (config.medianPrepass > 0) {
+        data.yData = Filter::applyMedian(data.yData, config.medianPrepass, 1);
+    }
+    
+    // Single precision replaces the double boxcar/SG path (serial direct passes only);
+    // filterPrecision 2 also runs the double filter to check the float result against
+    bool floatFilter = config.filterPrecision >= 1 &&
+                       (config.filterType == 1 || config.filterType == 2);
+    if (config.filterPrecision >= 1 && !floatFilter) {
+        cerr << "Warning: filterPrecision applies to boxcar and Savitzky-Golay only" << endl;
+    }
+    
+    // SG derivatives need a uniform x grid
+    bool sgDerivatives = false;
+    double spacing = 0.0;
+    if (config.sgDerivatives) {
+        if (config.filterType != 2) {
+            cerr << "Warning: sgDerivatives requires the Savitzky-Golay filter (type 2)" << endl;
+        } else if (!uniformSpacing(data.xData, spacing)) {
+            cerr << "Warning: sgDerivatives requires uniformly spaced x values; skipped" << endl;
+        } else {
+            sgDerivatives = true;
+        }
+    }
+    vector<vector<double>> derivativeColumns(3);
+    
     // Apply filter (if enabled)
     vector<double> filteredY = data.yData;
-    if (config.filterType == 1) {
+    if (floatFilter && config.filterPrecision == 1) {
+        // Float path below is the only filter run
+        if (config.numThreads != 1 || config.filterBackend != 1 || config.fusedFilter) {
+            cerr << "Warning: filterPrecision 1 runs serial direct passes; "
+                 << "threads, filterBackend and fusedFilter are ignored for filtering" << endl;
+        }
+    } else if (sgDerivatives && !floatFilter) {
+        // The SG run itself: the last pass also evaluates both derivative kernels
+        if (config.numThreads != 1 || config.filterBackend != 1 || config.fusedFilter) {
+            cerr << "Warning: sgDerivatives runs serial direct passes; "
+                 << "threads, filterBackend and fusedFilter are ignored for filtering" << endl;
+        }
+        if (Filter::applySavitzkyGolayDerivatives(data.yData, config.filterSize,
+                                                  config.filterPasses, config.sgOrder, spacing,
+                                                  derivativeColumns[0], derivativeColumns[1],
+                                                  derivativeColumns[2])) {
+            filteredY = derivativeColumns[0];
+        } else {
+            sgDerivatives = false;
+        }
+    } else if (config.fusedFilter && config.filterType >= 1 && config.filterType <= 3) {
+        // All passes streamed through ring buffers in one sweep
+        filteredY = Filter::applyFused(data.yData, config.filterType, config.filterSize,
+                                       config.filterPasses, config.sgOrder);
+    } else if (config.filterType == 1) {
         // Boxcar filter
-        filteredY = Filter::applyBoxcar(data.yData, config.filterSize, config.filterPasses);
+        filteredY = Filter::applyBoxcar(data.yData, config.filterSize, config.filterPasses,
+                                        config.numThreads, config.filterBackend);
     } else if (config.filterType == 2) {
         // Savitzky-Golay filter
-        filteredY = Filter::applySavitzkyGolay(data.yData, config.filterSize, config.filterPasses);
+        filteredY = Filter::applySavitzkyGolay(data.yData, config.filterSize, config.filterPasses,
+                                                   config.sgOrder, config.numThreads,
+                                                   config.filterBackend);
+    } else if (config.filterType == 3) {
+        // Median filter
+        filteredY = Filter::applyMedian(data.yData, config.filterSize, config.filterPasses);
+    } else if (config.filterType == 4) {
+        // Whittaker smoother
+        filteredY = Filter::applyWhittaker(data.yData, config.whittakerLambda, config.filterPasses);
+    } else if (config.filterType == 5) {
+        // Wavelet denoising
+        filteredY = Filter::applyWavelet(data.yData, config.waveletType, config.waveletLevels,
+                                         config.filterPasses);
     } else {
         cout << "Filtering disabled (filter type = 0)" << endl;
     }
     
+    // Single-precision filter path (checked against the double result above for filterPrecision 2)
+    double floatDeviation = -1.0;
+    double floatRelativeDeviation = -1.0;
+    if (floatFilter) {
+        vector<float> yFloat(data.yData.begin(), data.yData.end());
+        vector<float> filteredFloat = (config.filterType == 1)
+            ? Filter::applyBoxcarFloat(yFloat, config.filterSize, config.filterPasses)
+            : Filter::applySavitzkyGolayFloat(yFloat, config.filterSize,
+                                              config.filterPasses, config.sgOrder);
+        
+        if (config.filterPrecision == 2) {
+            double maxMagnitude = 0.0;
+            floatDeviation = 0.0;
+            for (size_t i = 0; i < filteredY.size(); i++) {
+                floatDeviation = max(floatDeviation, fabs(filteredFloat[i] - filteredY[i]));
+                maxMagnitude = max(maxMagnitude, fabs(filteredY[i]));
+            }
+            floatRelativeDeviation = (maxMagnitude > 0.0) ? floatDeviation / maxMagnitude : 0.0;
+            cout << "  Float32 max deviation from double path: " << floatDeviation
+                 << " (relative " << floatRelativeDeviation << ")" << endl;
+        }
+        
+        filteredY.assign(filteredFloat.begin(), filteredFloat.end());
+    }
+    
+    // SG derivatives of the smoothed signal (for derivative-based peak picking);
+    // the float path smooths separately, so the double sweep runs here
+    if (sgDerivatives && floatFilter) {
+        sgDerivatives = Filter::applySavitzkyGolayDerivatives(data.yData, config.filterSize,
+                                                              config.filterPasses, config.sgOrder,
+                                                              spacing, derivativeColumns[0],
+                                                              derivativeColumns[1],
+                                                              derivativeColumns[2]);
+    }
+    if (sgDerivatives) {
+        DataWriter::writeColumns("sg_derivatives.txt", data.xData, derivativeColumns,
+                                 "x smoothed dy/dx d2y/dx2 (Savitzky-Golay)");
+    }
+    
+    // All comparison filters side by side in one file
+    if (!config.compareSizes.empty()) {
+        vector<string> names;
+        vector<vector<double>> columns = Filter::compareFilters(data.yData, config.compareSizes,
+                                                                config.filterPasses, config.sgOrder,
+                                                                config.numThreads, names);
+        string header = "x";
+        for (const string& name : names) {
+            header += " " + name;
+        }
+        DataWriter::writeColumns("filter_comparison.txt", data.xData, columns, header);
+    }
+    
     // Save filtered data (if filtering was applied)
     if (config.filterType != 0) {
         DataWriter::writeData("filtered_data.txt", data.xData, filteredY,
@@ -111,14 +276,23 @@ int main(int argc, char* argv[]) {
     cout << endl;
     
     // Integrate peaks
-    PeakDetector::integratePeaks(peaks, spline, config.integrationType, config.tolerance);
+    if (config.integrationType == 4 || config.integrationType == 5) {
+        // Integrate the filtered samples directly (no spline quadrature)
+        PeakDetector::integratePeaksRaw(peaks, spline, data.xData, filteredY,
+                                        config.integrationType == 5, config.tolerance);
+    } else {
+        PeakDetector::integratePeaks(peaks, spline, config.integrationType, config.tolerance,
+                                     config.gaussOrder, config.numThreads,
+                                     config.integrationReport);
+    }
     cout << endl;
     
     // Calculate hydrogen ratios
     PeakDetector::calculateHydrogens(peaks);
     
     // Save peak data for plotting/analysis
-    DataWriter::writePeakData("peak_data.txt", peaks, config.baselineAdjustment);
+    DataWriter::writePeakData("peak_data.txt", peaks, config.baselineAdjustment,
+                              config.integrationReport);
     cout << endl;
     
     // Display results
@@ -134,7 +308,7 @@ int main(int argc, char* argv[]) {
     cout << "Baseline corrected (subtracted " << baselineValue << ")" << endl;
     
     // Print formatted peak table to console
-    PeakDetector::printPeaks(peaks);
+    PeakDetector::printPeaks(peaks, config.integrationReport);
     
     // Calculate execution time
     auto endTime = high_resolution_clock::now();
@@ -156,7 +330,27 @@ int main(int argc, char* argv[]) {
             outFile << "Filter Size         : " << config.filterSize << endl;
             outFile << "Filter Passes       : " << config.filterPasses << endl;
         }
+        if (config.filterType == 4) {
+            outFile << "Whittaker Lambda    : " << config.whittakerLambda << endl;
+        }
+        if (config.filterType == 5) {
+            outFile << "Wavelet             : " << (config.waveletType == 0 ? "Haar" : "Daubechies-4")
+                    << ", " << config.waveletLevels << " levels" << endl;
+        }
+        if (floatDeviation >= 0.0) {
+            outFile << "Filter Precision    : Float32 (max deviation " << floatDeviation
+                    << ", relative " << floatRelativeDeviation << ")" << endl;
+        } else if (floatFilter) {
+            outFile << "Filter Precision    : Float32" << endl;
+        }
+        if (config.medianPrepass > 0) {
+            outFile << "Median Pre-pass     : " << config.medianPrepass << endl;
+        }
         outFile << "Integration Method  : " << config.getIntegrationTypeName() << endl;
+        // Only when chosen explicitly, so default runs match the reference outputs
+        if (config.integrationType == 3 && config.gaussOrderSet) {
+            outFile << "Gauss-Legendre Order: " << config.gaussOrder << endl;
+        }
         outFile << "\nTechniques" << endl;
         outFile << "===============================" << endl;
         outFile << config.getIntegrationTypeName() << " Integration" << endl;
@@ -167,7 +361,7 @@ int main(int argc, char* argv[]) {
         outFile << "Baseline corrected (subtracted " << baselineValue << ")\n" << endl;
         
         // Write peak table to file
-        PeakDetector::printPeaks(outFile, peaks);
+        PeakDetector::printPeaks(outFile, peaks, config.integrationReport);
         
         outFile << "\nAnalysis took " << (duration.count() / 1000.0) << " seconds." << endl;
         
@@ -0,0 +1,68 @@
+#include "TestHelpers.h"
+#include "CubicSpline.h"
+#include <utility>
+
+using namespace std;
+
+/**
+ * CubicSpline tests - bulk evaluation against point-by-point evaluation
+ */
+
+/**
+ * The bulk forward-scan evaluate gives exactly the scalar results, in any
+ * order: ascending runs, backward steps, repeats, knots and points outside
+ * the data
+ */
+static void testBulkEvaluate() {
+    QuietOutput quiet;
+
+    // Uneven knot spacing
+    vector<double> y = Test::spectrum(400);
+    vector<double> x(y.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = 0.01 * static_cast<double>(i) + 0.003 * sin(static_cast<double>(i));
+    }
+    CubicSpline spline;
+    Test::check(spline.compute(x, y), "spline computed");
+
+    vector<double> ascending;
+    for (double xVal = -0.2; xVal < 4.2; xVal += 0.00137) {
+        ascending.push_back(xVal);
+    }
+    vector<double> descending(ascending.rbegin(), ascending.rend());
+
+    // Pseudo-random order with repeats, exact knots and both ends
+    vector<double> unsorted;
+    unsigned int seed = 5;
+    for (int k = 0; k < 3000; k++) {
+        seed = seed * 1103515245u + 12345u;
+        double u = static_cast<double>((seed >> 8) % 100000) / 100000.0;
+        unsorted.push_back(-0.3 + 4.6 * u);
+        if (k % 7 == 0) {
+            unsorted.push_back(x[(seed >> 4) % x.size()]);
+        }
+        if (k % 11 == 0) {
+            unsorted.push_back(unsorted[unsorted.size() / 2]);
+        }
+    }
+    unsorted.push_back(x.front());
+    unsorted.push_back(x.back());
+
+    vector<pair<string, vector<double>>> cases = {
+        {"ascending", ascending}, {"descending", descending}, {"unsorted", unsorted}};
+    for (const pair<string, vector<double>>& query : cases) {
+        vector<double> bulk;
+        spline.evaluate(query.second, bulk);
+        bool same = bulk.size() == query.second.size();
+        for (size_t k = 0; same && k < bulk.size(); k++) {
+            same = bulk[k] == spline.evaluate(query.second[k]);
+        }
+        Test::check(same, "bulk evaluate matches scalar (" + query.first + ")");
+    }
+}
+
+int main() {
+    testBulkEvaluate();
+
+    return Test::finish("CubicSplineTest");
+}
@@ -0,0 +1,106 @@
+#include "TestHelpers.h"
+#include "CumulativeIntegral.h"
+
+using namespace std;
+
+/**
+ * CumulativeIntegral tests - exact areas of polynomial data for bounds
+ * inside intervals, on samples and at the ends of the data
+ */
+
+/**
+ * Uniform grid on [0, 10] and a jittered grid on about the same range
+ * (the jittered one misses the direct index lookup)
+ */
+static vector<vector<double>> testGrids() {
+    vector<double> uniform(101);
+    vector<double> jittered(101);
+    for (size_t i = 0; i < uniform.size(); i++) {
+        uniform[i] = 0.1 * static_cast<double>(i);
+        jittered[i] = 0.1 * static_cast<double>(i) + 0.04 * sin(3.7 * static_cast<double>(i));
+    }
+    return {uniform, jittered};
+}
+
+/**
+ * Bounds pairs: inside one interval, across many, on samples, the full
+ * range, reversed and empty
+ */
+static vector<pair<double, double>> testBounds(const vector<double>& x) {
+    double first = x.front();
+    double last = x.back();
+    return {{0.537, 0.561}, {0.537, 7.913}, {x[3], x[57]}, {first, last}, {first, 4.321},
+            {6.789, last}, {first, x[1]}, {x[99], last}, {first + 1e-9, last - 1e-9},
+            {8.25, 1.75}, {3.3, 3.3}};
+}
+
+/**
+ * Largest |integrate(a, b) - exact(a, b)| over the test bounds
+ * @param f - data values y = f(x)
+ * @param antiderivative - F with F' = f
+ */
+template <typename Function, typename Antiderivative>
+static double worstError(const vector<double>& x, bool useSimpson, Function f,
+                         Antiderivative antiderivative) {
+    vector<double> y(x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        y[i] = f(x[i]);
+    }
+    CumulativeIntegral cumulative;
+    if (!cumulative.compute(x, y, useSimpson)) {
+        return INFINITY;
+    }
+
+    double worst = 0.0;
+    for (const auto& bounds : testBounds(x)) {
+        double exact = antiderivative(bounds.second) - antiderivative(bounds.first);
+        worst = max(worst, fabs(cumulative.integrate(bounds.first, bounds.second) - exact));
+    }
+    return worst;
+}
+
+/**
+ * Trapezoid is exact on linear data; Simpson on linear and quadratic data
+ * and, over whole intervals of a uniform grid, on cubic data
+ */
+static void testPolynomials() {
+    auto linear = [](double t) { return 3.0 - 2.5 * t; };
+    auto linearArea = [](double t) { return 3.0 * t - 1.25 * t * t; };
+    auto quadratic = [](double t) { return 1.0 + 0.5 * t - 0.75 * t * t; };
+    auto quadraticArea = [](double t) { return t + 0.25 * t * t - 0.25 * t * t * t; };
+
+    vector<vector<double>> grids = testGrids();
+    for (size_t g = 0; g < grids.size(); g++) {
+        string label = (g == 0) ? " (uniform grid)" : " (jittered grid)";
+        Test::check(worstError(grids[g], false, linear, linearArea) < 1e-12,
+                    "trapezoid exact on linear data" + label);
+        Test::check(worstError(grids[g], true, linear, linearArea) < 1e-12,
+                    "Simpson exact on linear data" + label);
+        Test::check(worstError(grids[g], true, quadratic, quadraticArea) < 1e-11,
+                    "Simpson exact on quadratic data" + label);
+    }
+
+    // Cubic: the two quadratics' errors cancel over a whole interval
+    const vector<double>& x = grids[0];
+    vector<double> y(x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        y[i] = x[i] * x[i] * x[i] - 4.0 * x[i];
+    }
+    auto cubicArea = [](double t) { return 0.25 * t * t * t * t - 2.0 * t * t; };
+    CumulativeIntegral cumulative;
+    cumulative.compute(x, y, true);
+    double worst = 0.0;
+    for (size_t i = 1; i + 2 < x.size(); i += 7) {
+        for (size_t j = i + 1; j + 1 < x.size(); j += 13) {
+            double exact = cubicArea(x[j]) - cubicArea(x[i]);
+            worst = max(worst, fabs(cumulative.integrate(x[i], x[j]) - exact));
+        }
+    }
+    Test::check(worst < 1e-9, "Simpson exact on cubic data between interior samples");
+}
+
+int main() {
+    testPolynomials();
+
+    return Test::finish("CumulativeIntegralTest");
+}
@@ -0,0 +1,182 @@
+#include "TestHelpers.h"
+#include "DataReader.h"
+#include <cstdio>
+#include <utility>
+
+using namespace std;
+
+/**
+ * DataReader tests - sorting, and the block/mapped parsers against the
+ * original getline/istringstream reader
+ *
+ * Usage: DataReaderTest [dataDir] (default ../data, for testdata.dat)
+ */
+
+/**
+ * The reader as it was before block parsing, sorted by x afterwards
+ */
+static bool readBaseline(const string& filename, vector<double>& xData, vector<double>& yData) {
+    ifstream inFile(filename);
+    if (!inFile.is_open()) {
+        return false;
+    }
+
+    vector<pair<double, double>> points;
+    string line;
+    double x, y;
+    while (getline(inFile, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream iss(line);
+        if (iss >> x >> y) {
+            points.push_back(make_pair(x, y));
+        }
+    }
+
+    stable_sort(points.begin(), points.end(),
+                [](const pair<double, double>& a, const pair<double, double>& b) {
+                    return a.first < b.first;
+                });
+    xData.clear();
+    yData.clear();
+    for (const auto& point : points) {
+        xData.push_back(point.first);
+        yData.push_back(point.second);
+    }
+    return true;
+}
+
+/**
+ * Read a file with DataReader and with the baseline reader and compare
+ */
+static void compareWithBaseline(const string& filename, int numThreads, const string& label) {
+    vector<double> baseX, baseY;
+    Test::check(readBaseline(filename, baseX, baseY), label + ": baseline reads the file");
+
+    QuietOutput quiet;
+    DataReader reader;
+    bool ok = reader.readFromFile(filename, numThreads);
+    Test::check(ok && reader.xData == baseX && reader.yData == baseY,
+                label + ": same points as the baseline reader");
+}
+
+/**
+ * Ascending, strictly descending, descending with ties and unsorted input
+ */
+static void testSort() {
+    QuietOutput quiet;
+
+    // y is a function of x, so a mismatched pair shows up as y != 2x + 1
+    auto pairsKept = [](const DataReader& reader) {
+        for (size_t i = 0; i < reader.size(); i++) {
+            if (reader.yData[i] != 2.0 * reader.xData[i] + 1.0) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto load = [](DataReader& reader, const vector<double>& x) {
+        reader.xData = x;
+        reader.yData.resize(x.size());
+        for (size_t i = 0; i < x.size(); i++) {
+            reader.yData[i] = 2.0 * x[i] + 1.0;
+        }
+    };
+
+    vector<double> ascending = {-1.0, 0.0, 0.0, 2.5, 7.0};
+    DataReader reader;
+    load(reader, ascending);
+    reader.sortData();
+    Test::check(reader.xData == ascending && pairsKept(reader), "ascending input unchanged");
+
+    vector<double> descending = {7.0, 2.5, 0.0, -1.0, -3.0};
+    load(reader, descending);
+    size_t before = quiet.text().size();
+    reader.sortData();
+    Test::check(reader.isSorted() && reader.xData.front() == -3.0 && pairsKept(reader),
+                "strictly descending input reversed");
+    Test::check(quiet.text().find("reversed", before) != string::npos,
+                "strictly descending input takes the O(n) reversal");
+
+    vector<double> ties = {7.0, 2.5, 2.5, 0.0, -1.0};
+    load(reader, ties);
+    before = quiet.text().size();
+    reader.sortData();
+    Test::check(reader.isSorted() && pairsKept(reader), "descending input with ties sorted");
+    Test::check(quiet.text().find("reversed", before) == string::npos,
+                "descending input with ties is not simply reversed");
+
+    load(reader, vector<double>(1, 4.0));
+    reader.sortData();
+    Test::check(reader.size() == 1 && pairsKept(reader), "single point");
+
+    // Below and above the parallel threshold, on one and several threads
+    for (size_t n : {size_t(1000), size_t(200003)}) {
+        vector<double> x(n);
+        unsigned int seed = 7;
+        for (size_t i = 0; i < n; i++) {
+            seed = seed * 1103515245u + 12345u;
+            x[i] = static_cast<double>(seed >> 8) / 1024.0 - 4096.0;
+        }
+        vector<double> sorted = x;
+        sort(sorted.begin(), sorted.end());
+
+        for (int threads : {1, 4}) {
+            load(reader, x);
+            reader.sortData(threads);
+            Test::check(reader.xData == sorted && pairsKept(reader),
+                        "unsorted input, n = " + to_string(n) + ", " + to_string(threads) +
+                        " threads");
+        }
+    }
+}
+
+/**
+ * Block and mapped parsers against the baseline reader
+ */
+static void testParse(const string& dataDir) {
+    string bundled = dataDir + "/testdata.dat";
+    compareWithBaseline(bundled, 1, "testdata.dat");
+    compareWithBaseline(bundled, 4, "testdata.dat (4 threads)");
+
+    // Comments, blank lines, CRLF, a leading '+', malformed lines and no
+    // final newline
+    string edgeFile = "DataReaderTest_edges.tmp";
+    {
+        ofstream out(edgeFile, ios::binary);
+        out << "# header\n\n3.5 10\n  2.25\t-4e2\r\n+1.0 +2.0\n1.5abc 2\n1,2\n"
+            << "#1 1\n .5 .25 extra\n0x10 1\n-0.75 1e-3\n9 8";
+    }
+    compareWithBaseline(edgeFile, 1, "edge cases");
+    remove(edgeFile.c_str());
+
+    // Large enough for the memory-mapped parallel parser, with lines cut at
+    // every chunk boundary
+    string largeFile = "DataReaderTest_large.tmp";
+    {
+        ofstream out(largeFile);
+        vector<double> y = Test::spectrum(600000);
+        char line[64];
+        for (size_t i = 0; i < y.size(); i++) {
+            snprintf(line, sizeof(line), "%.9f %.6f\n", 11.0 - 1.7e-5 * i, y[i]);
+            out << line;
+            if (i % 50000 == 0) {
+                out << "# block " << i << "\n\n";
+            }
+        }
+    }
+    compareWithBaseline(largeFile, 1, "large file");
+    compareWithBaseline(largeFile, 4, "large file (4 threads)");
+    compareWithBaseline(largeFile, 7, "large file (7 threads)");
+    remove(largeFile.c_str());
+}
+
+int main(int argc, char* argv[]) {
+    string dataDir = (argc > 1) ? argv[1] : "../data";
+
+    testSort();
+    testParse(dataDir);
+
+    return Test::finish("DataReaderTest");
+}
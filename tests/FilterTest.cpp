@@ -0,0 +1,474 @@
+#include "TestHelpers.h"
+#include "Filter.h"
+#include "StreamingFilter.h"
+#include "Whittaker.h"
+
+using namespace std;
+
+/**
+ * Filter tests - every alternative filter path against the serial
+ * direct-pass filters (applyBoxcar / applySavitzkyGolay with defaults)
+ */
+
+/**
+ * Tiled filtering on several threads is bit-identical to one thread
+ */
+static void testTiled() {
+    QuietOutput quiet;
+
+    // Longer than several 16384-point tiles, with a ragged last tile
+    vector<double> data = Test::spectrum(70001);
+
+    for (int size : {3, 9, 25}) {
+        for (int passes : {1, 4}) {
+            vector<double> serial = Filter::applyBoxcar(data, size, passes, 1);
+            vector<double> tiled = Filter::applyBoxcar(data, size, passes, 4);
+            Test::check(serial == tiled, "tiled boxcar size " + to_string(size) +
+                        ", " + to_string(passes) + " passes");
+        }
+    }
+
+    for (int size : {5, 11, 17}) {
+        for (int order : {2, 4}) {
+            vector<double> serial = Filter::applySavitzkyGolay(data, size, 3, order, 1);
+            vector<double> tiled = Filter::applySavitzkyGolay(data, size, 3, order, 3);
+            Test::check(serial == tiled, "tiled SG size " + to_string(size) +
+                        ", order " + to_string(order));
+        }
+    }
+}
+
+/**
+ * The buffer APIs (pointer overloads and InPlace variants) match the
+ * vector filters, including in place (data == dest) for any pass count
+ */
+static void testBuffers() {
+    QuietOutput quiet;
+
+    vector<double> data = Test::spectrum(5003);
+    size_t n = data.size();
+    for (int passes : {1, 2, 3}) {
+        string label = ", " + to_string(passes) + " passes";
+        vector<double> boxcar = Filter::applyBoxcar(data, 9, passes);
+        vector<double> sg = Filter::applySavitzkyGolay(data, 11, passes, 4);
+        vector<double> scratch(n);
+
+        vector<double> dest(n);
+        Filter::applyBoxcar(data.data(), dest.data(), n, 9, passes, scratch.data());
+        Test::check(dest == boxcar, "boxcar into dest" + label);
+        Filter::applySavitzkyGolay(data.data(), dest.data(), n, 11, passes, scratch.data(), 4);
+        Test::check(dest == sg, "SG into dest" + label);
+
+        vector<double> same = data;
+        Filter::applyBoxcar(same.data(), same.data(), n, 9, passes, scratch.data());
+        Test::check(same == boxcar, "boxcar with data == dest" + label);
+        same = data;
+        Filter::applySavitzkyGolay(same.data(), same.data(), n, 11, passes, scratch.data(), 4);
+        Test::check(same == sg, "SG with data == dest" + label);
+
+        // Scratch starts empty, then larger than the data
+        for (size_t scratchSize : {size_t(0), n + 100}) {
+            string sized = label + ", scratch " + to_string(scratchSize);
+            vector<double> work(scratchSize);
+            vector<double> inPlace = data;
+            Filter::applyBoxcarInPlace(inPlace, 9, passes, work);
+            Test::check(inPlace == boxcar, "applyBoxcarInPlace" + sized);
+            inPlace = data;
+            Filter::applySavitzkyGolayInPlace(inPlace, 11, passes, work, 4);
+            Test::check(inPlace == sg, "applySavitzkyGolayInPlace" + sized);
+        }
+    }
+}
+
+/**
+ * Fused (streaming) filtering is bit-identical to the batch filters,
+ * whatever the chunk size the samples arrive in
+ */
+static void testFused() {
+    QuietOutput quiet;
+
+    // Includes inputs shorter than the window and than the stream's start-up
+    for (size_t n : {size_t(1), size_t(7), size_t(40), size_t(5003)}) {
+        vector<double> data = Test::spectrum(n, static_cast<unsigned int>(n));
+        string length = " (n = " + to_string(n) + ")";
+
+        for (int passes : {1, 3}) {
+            string label = ", " + to_string(passes) + " passes" + length;
+            Test::check(Filter::applyFused(data, 1, 9, passes) ==
+                        Filter::applyBoxcar(data, 9, passes), "fused boxcar" + label);
+            Test::check(Filter::applyBoxcarFused(data, 9, passes) ==
+                        Filter::applyBoxcar(data, 9, passes), "applyBoxcarFused" + label);
+            Test::check(Filter::applyFused(data, 2, 11, passes, 4) ==
+                        Filter::applySavitzkyGolay(data, 11, passes, 4), "fused SG" + label);
+            Test::check(Filter::applyFused(data, 3, 5, passes) ==
+                        Filter::applyMedian(data, 5, passes), "fused median" + label);
+        }
+    }
+
+    // Push the same samples in uneven chunks
+    vector<double> data = Test::spectrum(10007);
+    vector<double> batch = Filter::applySavitzkyGolay(data, 7, 2);
+    for (size_t chunk : {size_t(1), size_t(13), size_t(4096)}) {
+        StreamingFilter stream(2, 7, 2);
+        vector<double> streamed;
+        for (size_t start = 0; start < data.size(); start += chunk) {
+            stream.push(data.data() + start, min(chunk, data.size() - start), streamed);
+        }
+        stream.finish(streamed);
+        Test::check(streamed == batch, "streamed SG in chunks of " + to_string(chunk));
+    }
+
+    // Stream positions past INT_MAX read the same ring slots
+    size_t offset = size_t(1) << 31;
+    for (int type : {1, 2, 3}) {
+        StreamingFilter stream(type, 7, 3);
+        vector<double> streamed;
+        stream.push(data.data(), 2000, streamed);
+        bool skipped = stream.skipAhead(offset);
+        stream.push(data.data() + 2000, data.size() - 2000, streamed);
+        stream.finish(streamed);
+        string label = " (filter type " + to_string(type) + ")";
+        Test::check(skipped && stream.samplesOut() == offset + data.size(),
+                    "stream skips past INT_MAX" + label);
+        vector<double> expected = (type == 1) ? Filter::applyBoxcar(data, 7, 3)
+                                : (type == 2) ? Filter::applySavitzkyGolay(data, 7, 3)
+                                              : Filter::applyMedian(data, 7, 3);
+        Test::check(streamed == expected, "stream past INT_MAX matches batch" + label);
+    }
+}
+
+/**
+ * SG derivatives are exact on polynomials the fit can represent, and the
+ * smoothed column is the plain SG filter
+ */
+static void testDerivatives() {
+    QuietOutput quiet;
+
+    size_t n = 400;
+    double spacing = 0.01;
+    for (int order : {2, 4}) {
+        // Quadratic for order 2, quartic for order 4 (x in [-2, 2))
+        vector<double> y(n);
+        vector<double> dy(n);
+        vector<double> d2y(n);
+        for (size_t i = 0; i < n; i++) {
+            double x = -2.0 + spacing * static_cast<double>(i);
+            if (order == 2) {
+                y[i] = 3.0 - 2.0 * x + 1.5 * x * x;
+                dy[i] = -2.0 + 3.0 * x;
+                d2y[i] = 3.0;
+            } else {
+                y[i] = 1.0 + x - 0.5 * x * x + 0.25 * x * x * x * x;
+                dy[i] = 1.0 - x + x * x * x;
+                d2y[i] = -1.0 + 3.0 * x * x;
+            }
+        }
+
+        for (int passes : {1, 3}) {
+            string label = ", order " + to_string(order) + ", " + to_string(passes) + " passes";
+            int size = 11;
+            vector<double> smoothed, first, second;
+            bool ok = Filter::applySavitzkyGolayDerivatives(y, size, passes, order, spacing,
+                                                            smoothed, first, second);
+            Test::check(ok, "SG derivatives run" + label);
+            Test::check(smoothed == Filter::applySavitzkyGolay(y, size, passes, order),
+                        "SG derivatives smoothed column" + label);
+
+            // Interior: no reflected sample reaches any pass
+            size_t edge = static_cast<size_t>(passes * (size - 1) / 2);
+            double firstError = 0.0;
+            double secondError = 0.0;
+            for (size_t i = edge; i < n - edge; i++) {
+                firstError = max(firstError, fabs(first[i] - dy[i]));
+                secondError = max(secondError, fabs(second[i] - d2y[i]));
+            }
+            Test::check(firstError < 1e-9, "SG first derivative exact" + label);
+            Test::check(secondError < 1e-6, "SG second derivative exact" + label);
+        }
+    }
+}
+
+/**
+ * Median of each reflected window by sorting (reference for the
+ * sliding-window median)
+ */
+static vector<double> sortedMedian(const vector<double>& data, int filterSize, int numPasses) {
+    vector<double> current = data;
+    long n = static_cast<long>(data.size());
+    long halfWidth = (filterSize - 1) / 2;
+    for (int pass = 0; pass < numPasses; pass++) {
+        vector<double> next(data.size());
+        for (long i = 0; i < n; i++) {
+            vector<double> window;
+            for (long j = i - halfWidth; j <= i + halfWidth; j++) {
+                // Mirror once at each end, then clamp (windows wider than the data)
+                long idx = (j < 0) ? -j : j;
+                idx = (idx >= n) ? 2 * n - idx - 2 : idx;
+                window.push_back(current[max(0L, min(idx, n - 1))]);
+            }
+            sort(window.begin(), window.end());
+            next[i] = window[halfWidth];
+        }
+        current = next;
+    }
+    return current;
+}
+
+/**
+ * The sliding-window median matches a sort of every window, with tied
+ * values, reflected edges and windows wider than the data
+ */
+static void testMedian() {
+    QuietOutput quiet;
+
+    for (size_t n : {size_t(1), size_t(2), size_t(4), size_t(9), size_t(301)}) {
+        // Few distinct values, so most windows hold ties
+        vector<double> spectrum = Test::spectrum(n, static_cast<unsigned int>(n));
+        vector<double> tied(n);
+        for (size_t i = 0; i < n; i++) {
+            tied[i] = fmod(floor(fabs(spectrum[i]) * 3.0), 4.0);
+        }
+
+        for (const vector<double>* data : {&spectrum, &tied}) {
+            for (int size : {1, 3, 5, 9, 21}) {
+                for (int passes : {1, 3}) {
+                    string label = " (n = " + to_string(n) + ", size " + to_string(size) +
+                                   ", " + to_string(passes) + " passes" +
+                                   (data == &tied ? ", ties)" : ")");
+                    Test::check(Filter::applyMedian(*data, size, passes) ==
+                                sortedMedian(*data, size, passes), "median" + label);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Every compareFilters column matches its standalone filter: SG exactly,
+ * boxcar (direct first-pass sums) to the last bit or so
+ */
+static void testCompare() {
+    QuietOutput quiet;
+
+    vector<double> data = Test::spectrum(3001);
+    // Size 1, duplicates, an even size and a negative size (both skipped)
+    vector<int> sizes = {9, 1, 4, 5, 5, 3, -3};
+    vector<int> boxSizes = {1, 3, 5, 9};
+    vector<int> sgSizes = {3, 5, 9};
+
+    for (int order : {2, 4}) {
+        for (int passes : {1, 2, 5}) {
+            string label = ", order " + to_string(order) + ", " + to_string(passes) + " passes";
+            vector<string> names;
+            vector<vector<double>> columns = Filter::compareFilters(data, sizes, passes, order,
+                                                                    2, names);
+
+            vector<string> expectedNames = {"none"};
+            for (int size : boxSizes) {
+                expectedNames.push_back("boxcar" + to_string(size));
+            }
+            for (int size : sgSizes) {
+                expectedNames.push_back("sg" + to_string(size));
+            }
+            Test::check(names == expectedNames && columns.size() == names.size(),
+                        "compare column names" + label);
+            if (columns.size() != expectedNames.size()) {
+                continue;
+            }
+
+            Test::check(columns[0] == data, "compare data column" + label);
+            for (size_t v = 0; v < boxSizes.size(); v++) {
+                double difference = Test::relativeDifference(
+                    Filter::applyBoxcar(data, boxSizes[v], passes), columns[1 + v]);
+                Test::check(difference < 1e-14, "compare " + names[1 + v] + label);
+            }
+            for (size_t v = 0; v < sgSizes.size(); v++) {
+                size_t column = 1 + boxSizes.size() + v;
+                Test::check(columns[column] ==
+                            Filter::applySavitzkyGolay(data, sgSizes[v], passes, order),
+                            "compare " + names[column] + label);
+            }
+        }
+    }
+}
+
+/**
+ * Dense solve of (I + lambda D'D) z = y by Gaussian elimination
+ * (reference for the banded Whittaker factor)
+ */
+static vector<double> denseWhittaker(const vector<double>& y, double lambda) {
+    size_t n = y.size();
+    vector<vector<double>> a(n, vector<double>(n + 1, 0.0));
+    for (size_t i = 0; i < n; i++) {
+        a[i][i] = 1.0;
+        a[i][n] = y[i];
+    }
+    // Each second difference row (1, -2, 1) at i-1, i, i+1 adds lambda r r'
+    const double row[3] = {1.0, -2.0, 1.0};
+    for (size_t i = 1; i + 1 < n; i++) {
+        for (int p = 0; p < 3; p++) {
+            for (int q = 0; q < 3; q++) {
+                a[i - 1 + p][i - 1 + q] += lambda * row[p] * row[q];
+            }
+        }
+    }
+    for (size_t col = 0; col < n; col++) {
+        for (size_t r = col + 1; r < n; r++) {
+            double factor = a[r][col] / a[col][col];
+            for (size_t c = col; c <= n; c++) {
+                a[r][c] -= factor * a[col][c];
+            }
+        }
+    }
+    vector<double> z(n);
+    for (size_t i = n; i-- > 0;) {
+        double sum = a[i][n];
+        for (size_t c = i + 1; c < n; c++) {
+            sum -= a[i][c] * z[c];
+        }
+        z[i] = sum / a[i][i];
+    }
+    return z;
+}
+
+/**
+ * The banded Whittaker factor matches a dense solve, including when the
+ * factor comes from the (n, lambda) cache
+ */
+static void testWhittaker() {
+    QuietOutput quiet;
+
+    vector<double> data = Test::spectrum(200);
+    vector<double> other = Test::spectrum(200, 7);
+    for (double lambda : {0.0, 1.0, 100.0, 1e4}) {
+        string label = " (lambda " + to_string(lambda) + ")";
+        vector<double> first = Filter::applyWhittaker(data, lambda, 1);
+        Test::check(Test::relativeDifference(denseWhittaker(data, lambda), first) < 1e-12,
+                    "Whittaker matches dense solve" + label);
+
+        // Same (n, lambda): the cached factor, on new data and on the same data
+        vector<double> cached = Filter::applyWhittaker(other, lambda, 1);
+        Test::check(Test::relativeDifference(denseWhittaker(other, lambda), cached) < 1e-12,
+                    "cached Whittaker factor matches dense solve" + label);
+        Test::check(Filter::applyWhittaker(data, lambda, 1) == first,
+                    "cached Whittaker factor repeats the result" + label);
+    }
+
+    // More (n, lambda) pairs than the cache holds, then the first again
+    vector<double> expected = Filter::applyWhittaker(data, 50.0, 1);
+    for (size_t extra = 0; extra <= Whittaker::maxCachedFactors; extra++) {
+        vector<double> shorter(data.begin(), data.end() - static_cast<long>(extra) - 1);
+        Filter::applyWhittaker(shorter, 50.0, 1);
+    }
+    Test::check(Filter::applyWhittaker(data, 50.0, 1) == expected,
+                "Whittaker factor rebuilt after eviction");
+}
+
+/**
+ * Wavelet denoising keeps constant and linear signals exactly, edges
+ * included, and does not move a peak's centroid
+ */
+static void testWavelet() {
+    QuietOutput quiet;
+
+    size_t n = 500;
+    vector<double> flat(n, 7.0);
+    vector<double> ramp(n);
+    vector<double> peak(n);
+    for (size_t i = 0; i < n; i++) {
+        double x = static_cast<double>(i);
+        ramp[i] = 0.5 * x - 20.0;
+        peak[i] = 100.0 * exp(-pow((x - 250.3) / 8.0, 2));
+    }
+
+    for (int family : {0, 1}) {
+        for (int levels : {1, 3, 6}) {
+            string label = string(family == 0 ? " (Haar" : " (D4") + ", " +
+                           to_string(levels) + " levels)";
+            Test::check(Test::relativeDifference(flat, Filter::applyWavelet(flat, family,
+                                                                            levels, 1)) < 1e-13,
+                        "wavelet keeps a constant" + label);
+
+            // Largest error over the whole ramp, first and last points included
+            vector<double> smoothRamp = Filter::applyWavelet(ramp, family, levels, 2);
+            double rampError = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                rampError = max(rampError, fabs(smoothRamp[i] - ramp[i]));
+            }
+            Test::check(rampError < 1e-10, "wavelet keeps a ramp to the edges" + label);
+
+            vector<double> smoothPeak = Filter::applyWavelet(peak, family, levels, 1);
+            double moment = 0.0, area = 0.0, smoothMoment = 0.0, smoothArea = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                moment += peak[i] * static_cast<double>(i);
+                area += peak[i];
+                smoothMoment += smoothPeak[i] * static_cast<double>(i);
+                smoothArea += smoothPeak[i];
+            }
+            Test::check(fabs(smoothMoment / smoothArea - moment / area) < 1e-6,
+                        "wavelet keeps a peak centroid" + label);
+        }
+    }
+}
+
+/**
+ * The FFT backend agrees with direct passes to rounding error
+ */
+static void testFFT() {
+    QuietOutput quiet;
+
+    vector<double> data = Test::spectrum(30011);
+    for (int passes : {1, 5, 40}) {
+        string label = ", " + to_string(passes) + " passes";
+        double boxcar = Test::relativeDifference(Filter::applyBoxcar(data, 9, passes, 1, 1),
+                                                 Filter::applyBoxcar(data, 9, passes, 1, 2));
+        double sg = Test::relativeDifference(Filter::applySavitzkyGolay(data, 17, passes, 2, 1, 1),
+                                             Filter::applySavitzkyGolay(data, 17, passes, 2, 1, 2));
+        Test::check(boxcar < 1e-12, "FFT boxcar" + label);
+        Test::check(sg < 1e-12, "FFT SG" + label);
+    }
+
+    // Short inputs fall back to direct passes (with a warning on cerr)
+    vector<double> shortData = Test::spectrum(6);
+    Test::check(Filter::applyBoxcar(shortData, 9, 2, 1, 2) == Filter::applyBoxcar(shortData, 9, 2),
+                "FFT boxcar falls back for short input");
+}
+
+/**
+ * The float32 path stays within float resolution of the double path
+ */
+static void testFloat() {
+    QuietOutput quiet;
+
+    // Odd length exercises the SIMD tails
+    vector<double> data = Test::spectrum(20003);
+    vector<float> floatData(data.begin(), data.end());
+    vector<double> rounded(floatData.begin(), floatData.end());
+
+    for (int passes : {1, 3}) {
+        string label = ", " + to_string(passes) + " passes";
+        vector<float> boxcar = Filter::applyBoxcarFloat(floatData, 11, passes);
+        vector<float> sg = Filter::applySavitzkyGolayFloat(floatData, 11, passes, 4);
+        double boxcarDiff = Test::relativeDifference(
+            Filter::applyBoxcar(rounded, 11, passes), vector<double>(boxcar.begin(), boxcar.end()));
+        double sgDiff = Test::relativeDifference(
+            Filter::applySavitzkyGolay(rounded, 11, passes, 4), vector<double>(sg.begin(), sg.end()));
+        Test::check(boxcarDiff < 1e-6, "float boxcar" + label);
+        Test::check(sgDiff < 1e-6, "float SG" + label);
+    }
+}
+
+int main() {
+    testTiled();
+    testBuffers();
+    testFused();
+    testDerivatives();
+    testMedian();
+    testCompare();
+    testWhittaker();
+    testWavelet();
+    testFFT();
+    testFloat();
+
+    return Test::finish("FilterTest");
+}
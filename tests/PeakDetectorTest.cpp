@@ -0,0 +1,81 @@
+#include "TestHelpers.h"
+#include "PeakDetector.h"
+
+using namespace std;
+
+/**
+ * PeakDetector tests - threaded peak integration against the serial run
+ */
+
+/**
+ * Spline through the synthetic spectrum on x in [0, 10)
+ */
+static CubicSpline spectrumSpline(size_t n) {
+    QuietOutput quiet;
+    vector<double> y = Test::spectrum(n);
+    vector<double> x(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = 10.0 * static_cast<double>(i) / static_cast<double>(n);
+    }
+    CubicSpline spline;
+    spline.compute(x, y);
+    return spline;
+}
+
+/**
+ * Peaks of uneven widths across the spectrum, more than the largest
+ * thread count so every worker gets several
+ */
+static vector<Peak> testPeaks() {
+    vector<Peak> peaks;
+    double begin = 0.05;
+    for (int i = 0; i < 37; i++) {
+        Peak peak = Peak();
+        peak.begin = begin;
+        peak.end = begin + 0.04 + 0.03 * (i % 7);
+        peaks.push_back(peak);
+        begin = peak.end + 0.01 * (i % 3);
+    }
+    return peaks;
+}
+
+/**
+ * integratePeaks gives the same areas, stats and methods for 1, 2 and 8
+ * threads, for every spline method and the automatic choice
+ */
+static void testThreadCounts() {
+    QuietOutput quiet;
+    CubicSpline spline = spectrumSpline(4000);
+
+    for (int method : {0, 1, 2, 3, 6}) {
+        for (bool collectStats : {false, true}) {
+            string label = " (method " + to_string(method) +
+                           (collectStats ? ", with stats)" : ")");
+            vector<Peak> serial = testPeaks();
+            PeakDetector::integratePeaks(serial, spline, method, 1e-6, 64, 1, collectStats);
+
+            for (int threads : {2, 8}) {
+                vector<Peak> threaded = testPeaks();
+                PeakDetector::integratePeaks(threaded, spline, method, 1e-6, 64, threads,
+                                             collectStats);
+
+                bool same = threaded.size() == serial.size();
+                for (size_t i = 0; same && i < serial.size(); i++) {
+                    const IntegrationStats& a = serial[i].stats;
+                    const IntegrationStats& b = threaded[i].stats;
+                    same = threaded[i].area == serial[i].area &&
+                           threaded[i].method == serial[i].method &&
+                           a.evaluations == b.evaluations && a.levels == b.levels &&
+                           a.converged == b.converged && a.errorEstimate == b.errorEstimate;
+                }
+                Test::check(same, to_string(threads) + " threads match the serial areas" + label);
+            }
+        }
+    }
+}
+
+int main() {
+    testThreadCounts();
+
+    return Test::finish("PeakDetectorTest");
+}
@@ -0,0 +1,139 @@
+#include "TestHelpers.h"
+#include "SavitzkyGolay.h"
+
+using namespace std;
+
+/**
+ * SavitzkyGolay tests - Gram-polynomial tables against the original
+ * integer tables and against a direct least-squares fit
+ */
+
+/**
+ * Weights for the polynomial coefficient of t^derivative, fitted by least
+ * squares over t = j / m, j = -m..m (normal equations in long double)
+ */
+static vector<long double> leastSquaresWeights(int windowSize, int polyOrder, int derivative) {
+    int m = (windowSize - 1) / 2;
+    int terms = polyOrder + 1;
+
+    // Augmented system [A'A | A'], one right-hand side per window point
+    vector<vector<long double>> rows(terms, vector<long double>(terms + windowSize, 0.0L));
+    for (int j = -m; j <= m; j++) {
+        long double t = static_cast<long double>(j) / m;
+        vector<long double> powers(2 * terms, 1.0L);
+        for (size_t k = 1; k < powers.size(); k++) {
+            powers[k] = powers[k - 1] * t;
+        }
+        for (int r = 0; r < terms; r++) {
+            for (int c = 0; c < terms; c++) {
+                rows[r][c] += powers[r + c];
+            }
+            rows[r][terms + j + m] = powers[r];
+        }
+    }
+
+    // Gauss-Jordan elimination (A'A is symmetric positive definite)
+    for (int p = 0; p < terms; p++) {
+        for (int r = 0; r < terms; r++) {
+            if (r != p) {
+                long double factor = rows[r][p] / rows[p][p];
+                for (size_t c = p; c < rows[r].size(); c++) {
+                    rows[r][c] -= factor * rows[p][c];
+                }
+            }
+        }
+    }
+
+    // d-th derivative at j = 0 per unit sample: d! a_d / m^d
+    long double scale = 1.0L;
+    for (int k = 1; k <= derivative; k++) {
+        scale *= static_cast<long double>(k) / m;
+    }
+    vector<long double> weights(windowSize);
+    for (int j = 0; j < windowSize; j++) {
+        weights[j] = scale * rows[derivative][terms + j] / rows[derivative][derivative];
+    }
+    return weights;
+}
+
+/**
+ * The tables that were hard-coded before coefficients were generated
+ */
+static void testOriginalTables() {
+    struct Original {
+        int size;
+        double norm;
+        vector<double> coeffs;
+    };
+    vector<Original> originals = {
+        {5, 35.0, {-3, 12, 17, 12, -3}},
+        {11, 429.0, {-36, 9, 44, 69, 84, 89, 84, 69, 44, 9, -36}},
+        {17, 323.0, {-21, -6, 7, 18, 27, 34, 39, 42, 43, 42, 39, 34, 27, 18, 7, -6, -21}}
+    };
+
+    for (const Original& original : originals) {
+        const double* coeffs = SavitzkyGolay::coefficients(original.size, 2);
+        bool match = coeffs != nullptr;
+        for (int j = 0; match && j < original.size; j++) {
+            match = fabs(coeffs[j] - original.coeffs[j] / original.norm) <= 1e-16;
+        }
+        Test::check(match, "size " + to_string(original.size) + " matches the original table");
+    }
+}
+
+/**
+ * Every window and order against the least-squares fit, plus the
+ * documented sum and symmetry properties
+ */
+static void testLeastSquares() {
+    for (int size = 3; size <= 31; size += 2) {
+        for (int order = 0; order <= SavitzkyGolay::maxPolyOrder && order < size; order++) {
+            for (int derivative = 0; derivative <= SavitzkyGolay::maxDerivative; derivative++) {
+                string label = "size " + to_string(size) + ", order " + to_string(order) +
+                               ", derivative " + to_string(derivative);
+                const double* coeffs = SavitzkyGolay::coefficients(size, order, derivative);
+                if (coeffs == nullptr) {
+                    Test::check(false, label + " has a table");
+                    continue;
+                }
+
+                double error = 0.0;
+                double sum = 0.0;
+                double asymmetry = 0.0;
+                vector<long double> expected = (derivative <= order)
+                    ? leastSquaresWeights(size, order, derivative)
+                    : vector<long double>(size, 0.0L);
+                for (int j = 0; j < size; j++) {
+                    error = max(error, fabs(coeffs[j] - static_cast<double>(expected[j])));
+                    sum += coeffs[j];
+                    double mirrored = (derivative == 1) ? -coeffs[size - 1 - j] : coeffs[size - 1 - j];
+                    asymmetry = max(asymmetry, fabs(coeffs[j] - mirrored));
+                }
+                Test::check(error < 1e-12, label + " matches least squares");
+                Test::check(asymmetry < 1e-14, label + " has the expected symmetry");
+                if (derivative == 0) {
+                    Test::check(fabs(sum - 1.0) < 1e-13, label + " sums to 1");
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Invalid requests return nullptr
+ */
+static void testInvalid() {
+    Test::check(SavitzkyGolay::coefficients(4, 2) == nullptr, "even window rejected");
+    Test::check(SavitzkyGolay::coefficients(1, 0) == nullptr, "window 1 rejected");
+    Test::check(SavitzkyGolay::coefficients(5, 5) == nullptr, "order >= window rejected");
+    Test::check(SavitzkyGolay::coefficients(21, 7) == nullptr, "order above 6 rejected");
+    Test::check(SavitzkyGolay::coefficients(9, 2, 3) == nullptr, "third derivative rejected");
+}
+
+int main() {
+    testOriginalTables();
+    testLeastSquares();
+    testInvalid();
+
+    return Test::finish("SavitzkyGolayTest");
+}
@@ -0,0 +1,173 @@
+#include "TestHelpers.h"
+#include "SpectrumFile.h"
+#include "DataReader.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * SpectrumFile tests - write/open round trips, corrupt headers, and
+ * loading through DataReader
+ */
+
+static vector<char> readBytes(const string& filename) {
+    ifstream inFile(filename, ios::binary);
+    return vector<char>(istreambuf_iterator<char>(inFile), istreambuf_iterator<char>());
+}
+
+static void writeBytes(const string& filename, const vector<char>& bytes) {
+    ofstream outFile(filename, ios::binary);
+    outFile.write(bytes.data(), bytes.size());
+}
+
+/**
+ * Explicit x column and uniform grid, with metadata
+ */
+static void testRoundTrip() {
+    QuietOutput quiet;
+    string filename = "SpectrumFileTest_roundtrip.tmp";
+
+    // Irregular x: stored as a column, read back bit for bit
+    vector<double> y = Test::spectrum(1001);
+    vector<double> x(y.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = 0.01 * static_cast<double>(i) + 1e-4 * static_cast<double>(i % 7);
+    }
+    string metadata = "source=testdata.dat\nfilter=SG 11/4\n";
+    Test::check(SpectrumFile::write(filename, x, y, metadata), "explicit x written");
+    Test::check(SpectrumFile::isSpectrumFile(filename), "written file recognised");
+
+    SpectrumFile spectrum;
+    bool opened = spectrum.open(filename);
+    Test::check(opened, "explicit x opened");
+    if (opened) {
+        Test::check(spectrum.size() == y.size() && !spectrum.hasUniformGrid(),
+                    "explicit x size and layout");
+        Test::check(vector<double>(spectrum.xColumn(), spectrum.xColumn() + x.size()) == x,
+                    "x column round trip");
+        Test::check(vector<double>(spectrum.yColumn(), spectrum.yColumn() + y.size()) == y,
+                    "y column round trip (explicit x)");
+        Test::check(spectrum.metadata() == metadata, "metadata round trip");
+    }
+
+    // Exactly uniform x: stored as (x0, dx, n) with no x column
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = -2.0 + 0.125 * static_cast<double>(i);
+    }
+    Test::check(SpectrumFile::write(filename, x, y, ""), "uniform grid written");
+    opened = spectrum.open(filename);
+    Test::check(opened, "uniform grid opened");
+    if (opened) {
+        Test::check(spectrum.hasUniformGrid() && spectrum.xColumn() == nullptr,
+                    "uniform grid has no x column");
+        Test::check(spectrum.gridStart() == -2.0 && spectrum.gridStep() == 0.125,
+                    "grid start and step");
+        bool same = true;
+        for (size_t i = 0; i < x.size(); i++) {
+            same = same && spectrum.x(i) == x[i];
+        }
+        Test::check(same, "grid x values");
+        Test::check(vector<double>(spectrum.yColumn(), spectrum.yColumn() + y.size()) == y,
+                    "y column round trip (uniform grid)");
+        Test::check(spectrum.metadata().empty(), "empty metadata");
+        Test::check(readBytes(filename).size() == 64 + y.size() * sizeof(double),
+                    "uniform grid file holds only the header and y");
+    }
+    spectrum.close();
+    Test::check(!spectrum.isOpen(), "closed");
+
+    vector<double> shorter(3, 1.0);
+    Test::check(!SpectrumFile::write(filename, shorter, y, ""), "mismatched sizes rejected");
+
+    remove(filename.c_str());
+}
+
+/**
+ * Every damaged header is rejected rather than mapped (each rejection
+ * prints its expected error on cerr)
+ */
+static void testCorruptHeaders() {
+    QuietOutput quiet;
+    string good = "SpectrumFileTest_good.tmp";
+    string bad = "SpectrumFileTest_bad.tmp";
+
+    vector<double> y = Test::spectrum(100);
+    vector<double> x(y.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = static_cast<double>(i * i);
+    }
+    SpectrumFile::write(good, x, y, "key=value\n");
+    const vector<char> original = readBytes(good);
+
+    auto rejected = [&](size_t offset, uint64_t value, size_t width) {
+        vector<char> bytes = original;
+        memcpy(bytes.data() + offset, &value, width);
+        writeBytes(bad, bytes);
+        SpectrumFile spectrum;
+        return !spectrum.open(bad) && !spectrum.isOpen();
+    };
+
+    Test::check(rejected(0, 'X', 1), "bad magic rejected");
+    Test::check(rejected(8, 2, 4), "unknown version rejected");
+    Test::check(rejected(56, 0x04030201, 4), "other byte order rejected");
+    Test::check(rejected(16, y.size() + 1, 8), "count past the end rejected");
+    Test::check(rejected(16, UINT64_MAX / 8, 8), "huge count rejected");
+    Test::check(rejected(40, UINT64_MAX - 10, 8), "huge metadata size rejected");
+    Test::check(rejected(40, 200, 8), "metadata overlapping the data rejected");
+    Test::check(rejected(48, UINT64_MAX - 63, 8), "huge data offset rejected");
+    Test::check(rejected(48, 96, 8), "unaligned data offset rejected");
+
+    vector<char> truncated(original.begin(), original.end() - 8);
+    writeBytes(bad, truncated);
+    SpectrumFile spectrum;
+    Test::check(!spectrum.open(bad), "truncated file rejected");
+
+    writeBytes(bad, vector<char>(original.begin(), original.begin() + 40));
+    Test::check(!spectrum.open(bad), "file shorter than the header rejected");
+    Test::check(!SpectrumFile::isSpectrumFile(bad + ".missing"), "missing file not recognised");
+
+    remove(good.c_str());
+    remove(bad.c_str());
+}
+
+/**
+ * DataReader loads a spectrum file the same way as text
+ */
+static void testDataReader() {
+    QuietOutput quiet;
+    string filename = "SpectrumFileTest_reader.tmp";
+
+    // Stored in descending x, as spectra often are (x comes back from the
+    // grid, so only to rounding)
+    vector<double> y = Test::spectrum(500);
+    vector<double> x(y.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = 12.0 - 0.02 * static_cast<double>(i);
+    }
+    SpectrumFile::write(filename, x, y, "");
+
+    DataReader reader;
+    bool loaded = reader.readFromFile(filename);
+    Test::check(loaded && reader.size() == x.size(), "DataReader loads a spectrum file");
+    if (loaded) {
+        bool reversed = true;
+        for (size_t i = 0; i < x.size(); i++) {
+            size_t j = x.size() - 1 - i;
+            reversed = reversed && fabs(reader.xData[i] - x[j]) < 1e-12 && reader.yData[i] == y[j];
+        }
+        Test::check(reader.isSorted() && reversed, "spectrum file points sorted by x");
+    }
+
+    remove(filename.c_str());
+}
+
+int main() {
+    testRoundTrip();
+    testCorruptHeaders();
+    testDataReader();
+
+    return Test::finish("SpectrumFileTest");
+}
@@ -0,0 +1,115 @@
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Test class - Minimal checks shared by the test programs
+ *
+ * Each test program calls check() for every expectation and returns
+ * finish() from main, so "make test" stops at the first failing program.
+ */
+class Test {
+public:
+    /**
+     * Record one expectation
+     * @param condition - true if the expectation holds
+     * @param what - description printed on failure
+     */
+    static void check(bool condition, const string& what) {
+        checks()++;
+        if (!condition) {
+            failures()++;
+            cerr << "FAIL: " << what << endl;
+        }
+    }
+
+    /**
+     * Largest |a[i] - b[i]| relative to the largest |a[i]|
+     * (infinite if the sizes differ)
+     */
+    static double relativeDifference(const vector<double>& a, const vector<double>& b) {
+        if (a.size() != b.size()) {
+            return INFINITY;
+        }
+        double difference = 0.0;
+        double magnitude = 0.0;
+        for (size_t i = 0; i < a.size(); i++) {
+            difference = max(difference, fabs(a[i] - b[i]));
+            magnitude = max(magnitude, fabs(a[i]));
+        }
+        return magnitude > 0.0 ? difference / magnitude : difference;
+    }
+
+    /**
+     * Synthetic spectrum: Lorentzian peaks on a noisy baseline, with a few
+     * spikes; the same seed always gives the same samples
+     * @param n - number of points
+     * @param seed - noise seed
+     */
+    static vector<double> spectrum(size_t n, unsigned int seed = 1) {
+        vector<double> y(n);
+        for (size_t i = 0; i < n; i++) {
+            double x = 10.0 * static_cast<double>(i) / static_cast<double>(n);
+            seed = seed * 1103515245u + 12345u;
+            double noise = static_cast<double>((seed >> 16) % 2001) / 1000.0 - 1.0;
+            y[i] = 5000.0 / (1.0 + 900.0 * (x - 2.5) * (x - 2.5)) +
+                   1200.0 / (1.0 + 2500.0 * (x - 6.1) * (x - 6.1)) + 40.0 * noise;
+            if (i % 997 == 13) {
+                y[i] += 3000.0;
+            }
+        }
+        return y;
+    }
+
+    /**
+     * Print a summary line
+     * @param suite - test program name
+     * @return exit code (0 if every check passed)
+     */
+    static int finish(const string& suite) {
+        if (failures() == 0) {
+            cout << suite << ": all " << checks() << " checks passed" << endl;
+            return 0;
+        }
+        cout << suite << ": " << failures() << " of " << checks() << " checks FAILED" << endl;
+        return 1;
+    }
+
+private:
+    static int& checks() {
+        static int count = 0;
+        return count;
+    }
+
+    static int& failures() {
+        static int count = 0;
+        return count;
+    }
+};
+
+/**
+ * QuietOutput class - Discards cout (the library's progress lines) while
+ * in scope; failures still go to cerr
+ */
+class QuietOutput {
+public:
+    QuietOutput() : saved(cout.rdbuf(sink.rdbuf())) {}
+    ~QuietOutput() { cout.rdbuf(saved); }
+
+    // Everything written to cout so far
+    string text() const { return sink.str(); }
+
+private:
+    ostringstream sink;
+    streambuf* saved;
+};
+
+#endif // TESTHELPERS_H